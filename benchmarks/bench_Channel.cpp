@@ -0,0 +1,66 @@
+#include <benchmark/benchmark.h>
+
+#include <player/Channel.h>
+
+#include <cmath>
+#include <vector>
+
+// One voice looping over a few frames, where nearly every span ends at a loop wrap
+static void BM_ChannelShortLoop(benchmark::State& state)
+{
+    const auto loop_length = static_cast<size_t>(state.range(0));
+    const size_t frames = 4096;
+
+    std::vector<float> data(64 + loop_length);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = std::sin(static_cast<float>(i) * 0.3f);
+    }
+    Sample sample(data.begin(), data.end(), 8363,
+                  {Sample::LoopParams::Type::forward_looping, 64, 64 + loop_length});
+
+    Channel channel;
+    channel.set_frequency(8363.0f * 1.37f);
+    channel.play(&sample);
+
+    std::vector<float> buffer(frames);
+    for (auto _ : state) {
+        channel.mix(&buffer[0], frames, 44100);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    state.counters["frames_per_second"] = benchmark::Counter(
+        static_cast<double>(frames), benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_ChannelShortLoop)->ArgName("loop")->Arg(2)->Arg(8)->Arg(32)->Arg(256);
+
+// One voice from the start of a sample, at pitch ratios from an octave down to nearly two up.
+// The non-looping sample is long enough never to end; the looping one wraps every 2048 frames.
+static void BM_ChannelMix(benchmark::State& state)
+{
+    const bool looping = state.range(0) != 0;
+    const float ratio = static_cast<float>(state.range(1)) / 100.0f;
+    const size_t frames = 4096;
+
+    std::vector<float> data(looping ? 2048 : 4 * frames);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = std::sin(static_cast<float>(i) * 0.01f);
+    }
+    const auto loop = looping ? Sample::LoopParams{Sample::LoopParams::Type::forward_looping, 0,
+                                                   data.size()}
+                              : Sample::LoopParams{Sample::LoopParams::Type::non_looping};
+    Sample sample(data.begin(), data.end(), 8363, loop);
+
+    Channel channel;
+    channel.set_frequency(8363.0f * ratio);
+
+    std::vector<float> buffer(frames);
+    for (auto _ : state) {
+        channel.play(&sample);
+        channel.mix(&buffer[0], frames, 44100);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    state.counters["frames_per_second"] = benchmark::Counter(
+        static_cast<double>(frames), benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_ChannelMix)
+    ->ArgNames({"looping", "pitch_percent"})
+    ->ArgsProduct({{0, 1}, {50, 100, 137, 300}});
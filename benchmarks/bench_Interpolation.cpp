@@ -0,0 +1,35 @@
+#include <benchmark/benchmark.h>
+
+#include <player/Channel.h>
+
+#include <cmath>
+#include <vector>
+
+// The cost of one voice at each interpolation quality, so a deployment can pick the best
+// quality its CPU budget allows
+static void BM_InterpolationPerVoice(benchmark::State& state)
+{
+    const auto interpolation = static_cast<Interpolation>(state.range(0));
+    const size_t frames = 4096;
+
+    std::vector<float> data(65536);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = std::sin(static_cast<float>(i) * 0.01f);
+    }
+    Sample sample(data.begin(), data.end(), 8363);
+
+    Channel channel;
+    channel.set_frequency(8363.0f * 1.37f);
+    channel.play(&sample);
+
+    std::vector<float> buffer(frames);
+    for (auto _ : state) {
+        channel.mix(&buffer[0], frames, 44100, interpolation);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    state.counters["frames_per_second"] = benchmark::Counter(
+        static_cast<double>(frames), benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_InterpolationPerVoice)
+    ->ArgName("mode")
+    ->DenseRange(static_cast<int>(Interpolation::nearest), static_cast<int>(Interpolation::sinc16));
@@ -0,0 +1,157 @@
+#include <benchmark/benchmark.h>
+
+#include <loader/module.h>
+#include <player/Module.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Little endian writes into a growing file image
+struct FileImage {
+    std::vector<uint8_t> bytes;
+
+    void put(size_t at, const void* data, size_t size)
+    {
+        if (bytes.size() < at + size) {
+            bytes.resize(at + size);
+        }
+        std::memcpy(&bytes[at], data, size);
+    }
+    template <typename T> void put(size_t at, T value) { put(at, &value, sizeof(value)); }
+    // Where the next section starts, on the 16 byte boundary both formats' pointers need
+    size_t next() const { return (bytes.size() + 15) / 16 * 16; }
+};
+
+static const size_t generated_channels = 32;
+static const size_t generated_samples = 16;
+static const size_t generated_sample_length = 16384;
+
+// An S3M of `pattern_count` patterns, each with a note, volume and effect on every channel of
+// every row, and 16 8 bit samples
+static std::vector<uint8_t> generate_s3m(size_t pattern_count)
+{
+    FileImage s3m;
+    s3m.put<uint16_t>(0x20, static_cast<uint16_t>(pattern_count + 1));
+    s3m.put<uint16_t>(0x22, generated_samples);
+    s3m.put<uint16_t>(0x24, static_cast<uint16_t>(pattern_count));
+    s3m.put<uint8_t>(0x31, 6);
+    s3m.put<uint8_t>(0x32, 125);
+    for (size_t p = 0; p < pattern_count; ++p) {
+        s3m.put<uint8_t>(0x60 + p, static_cast<uint8_t>(p));
+    }
+    s3m.put<uint8_t>(0x60 + pattern_count, 255);
+    const size_t instrument_pointers = 0x60 + pattern_count + 1;
+    const size_t pattern_pointers = instrument_pointers + 2 * generated_samples;
+    // Claim the pointer tables before anything is placed after them
+    s3m.put<uint16_t>(pattern_pointers + 2 * pattern_count - 2, 0);
+
+    for (size_t s = 0; s < generated_samples; ++s) {
+        const size_t header = s3m.next();
+        s3m.put<uint16_t>(instrument_pointers + 2 * s, static_cast<uint16_t>(header / 16));
+        s3m.put<uint32_t>(header + 0x10, generated_sample_length);
+        s3m.put<uint8_t>(header + 0x1C, 64);
+        s3m.put<uint16_t>(header + 0x20, 8363);
+        const size_t data = (header + 0x50 + 15) / 16 * 16;
+        s3m.put<uint16_t>(header + 0x0E, static_cast<uint16_t>(data / 16));
+        const std::vector<uint8_t> sample(generated_sample_length, static_cast<uint8_t>(s * 8));
+        s3m.put(data, sample.data(), sample.size());
+    }
+
+    std::vector<uint8_t> packed;
+    for (size_t r = 0; r < 64; ++r) {
+        for (size_t c = 0; c < generated_channels; ++c) {
+            const uint8_t note = static_cast<uint8_t>(0x40 | (r + c) % 12);
+            packed.insert(packed.end(), {static_cast<uint8_t>(c | 32 | 64 | 128), note,
+                                         static_cast<uint8_t>(1 + c % generated_samples), 48,
+                                         static_cast<uint8_t>(4 + r % 8), 0x12});
+        }
+        packed.push_back(0);
+    }
+    for (size_t p = 0; p < pattern_count; ++p) {
+        const size_t pattern = s3m.next();
+        s3m.put<uint16_t>(pattern_pointers + 2 * p, static_cast<uint16_t>(pattern / 16));
+        s3m.put<uint16_t>(pattern, static_cast<uint16_t>(packed.size()));
+        s3m.put(pattern + 2, packed.data(), packed.size());
+    }
+    return s3m.bytes;
+}
+
+// The same song as an IT
+static std::vector<uint8_t> generate_it(size_t pattern_count)
+{
+    FileImage it;
+    it.put<uint16_t>(0x20, static_cast<uint16_t>(pattern_count + 1));
+    it.put<uint16_t>(0x22, 0);
+    it.put<uint16_t>(0x24, generated_samples);
+    it.put<uint16_t>(0x26, static_cast<uint16_t>(pattern_count));
+    it.put<uint16_t>(0x2C, 1);
+    it.put<uint8_t>(0x32, 6);
+    it.put<uint8_t>(0x33, 125);
+    for (size_t c = 0; c < 64; ++c) {
+        it.put<uint8_t>(0x40 + c, 32);
+    }
+    for (size_t p = 0; p < pattern_count; ++p) {
+        it.put<uint8_t>(0xC0 + p, static_cast<uint8_t>(p));
+    }
+    it.put<uint8_t>(0xC0 + pattern_count, 255);
+    const size_t sample_pointers = 0xC0 + pattern_count + 1;
+    const size_t pattern_pointers = sample_pointers + 4 * generated_samples;
+    // Claim the pointer tables before anything is placed after them
+    it.put<uint32_t>(pattern_pointers + 4 * pattern_count - 4, 0);
+
+    for (size_t s = 0; s < generated_samples; ++s) {
+        const size_t header = it.next();
+        it.put<uint32_t>(sample_pointers + 4 * s, static_cast<uint32_t>(header));
+        it.put<uint8_t>(header + 0x12, 0x01);
+        it.put<uint8_t>(header + 0x13, 64);
+        it.put<uint32_t>(header + 0x30, generated_sample_length);
+        it.put<uint32_t>(header + 0x3C, 8363);
+        const size_t data = header + 0x50;
+        it.put<uint32_t>(header + 0x48, static_cast<uint32_t>(data));
+        const std::vector<uint8_t> sample(generated_sample_length, static_cast<uint8_t>(s * 8));
+        it.put(data, sample.data(), sample.size());
+    }
+
+    std::vector<uint8_t> packed;
+    for (size_t r = 0; r < 64; ++r) {
+        for (size_t c = 0; c < generated_channels; ++c) {
+            const uint8_t note = static_cast<uint8_t>(60 + (r + c) % 12);
+            packed.insert(packed.end(), {static_cast<uint8_t>((c + 1) | 128), 15, note,
+                                         static_cast<uint8_t>(1 + c % generated_samples), 48,
+                                         static_cast<uint8_t>(4 + r % 8), 0x12});
+        }
+        packed.push_back(0);
+    }
+    for (size_t p = 0; p < pattern_count; ++p) {
+        const size_t pattern = it.next();
+        it.put<uint32_t>(pattern_pointers + 4 * p, static_cast<uint32_t>(pattern));
+        it.put<uint16_t>(pattern, static_cast<uint16_t>(packed.size()));
+        it.put<uint16_t>(pattern + 2, 64);
+        it.put(pattern + 8, packed.data(), packed.size());
+    }
+    return it.bytes;
+}
+
+// Loading a generated module of a growing number of dense patterns out of memory, so the
+// parsing rather than the disk is measured
+template <ModuleFormat format> static void BM_LoadModule(benchmark::State& state)
+{
+    const auto pattern_count = static_cast<size_t>(state.range(0));
+    const auto file = format == ModuleFormat::s3m ? generate_s3m(pattern_count)
+                                                  : generate_it(pattern_count);
+    const auto loaded = load_module(file.data(), file.size(), format);
+    if (!is_playable(*loaded) || loaded->patterns.size() != pattern_count ||
+        loaded->samples.size() != generated_samples) {
+        state.SkipWithError("the generated module doesn't load");
+        return;
+    }
+    for (auto _ : state) {
+        auto module = load_module(file.data(), file.size(), format);
+        benchmark::DoNotOptimize(module.get());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            static_cast<int64_t>(file.size()));
+}
+BENCHMARK_TEMPLATE(BM_LoadModule, ModuleFormat::s3m)->ArgName("patterns")->Range(1, 64);
+BENCHMARK_TEMPLATE(BM_LoadModule, ModuleFormat::it)->ArgName("patterns")->Range(1, 64);
@@ -0,0 +1,152 @@
+#include <benchmark/benchmark.h>
+
+#include <player/Mixer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+static std::vector<Sample> make_samples(size_t count, size_t length)
+{
+    std::vector<Sample> samples;
+    for (size_t s = 0; s < count; ++s) {
+        std::vector<float> data(length);
+        for (size_t i = 0; i < length; ++i) {
+            data[i] = std::sin(static_cast<float>(i * (s + 1)) * 0.01f);
+        }
+        samples.emplace_back(data.begin(), data.end(), 8363);
+        samples.back().add_pcm16();
+    }
+    return samples;
+}
+
+template <typename MixerType>
+static void play_voices(MixerType& mixer, const std::vector<Sample>& samples, size_t voice_count)
+{
+    for (size_t c = 0; c < voice_count; ++c) {
+        mixer.channel(c).set_frequency(8363.0f * (1.0f + 0.03f * static_cast<float>(c)));
+        mixer.channel(c).set_volume(0.5f);
+        mixer.channel(c).play(&samples[c % samples.size()]);
+    }
+}
+
+// Inline stereo mixing as the number of voices playing grows
+static void BM_MixerRenderVoices(benchmark::State& state)
+{
+    const auto voice_count = static_cast<size_t>(state.range(0));
+    const size_t frames = 16384;
+    const auto samples = make_samples(16, 65536);
+
+    Mixer mixer(44100, voice_count);
+    mixer.set_samples_per_tick(882);
+    play_voices(mixer, samples, voice_count);
+
+    std::vector<float> buffer(frames * 2);
+    for (auto _ : state) {
+        mixer.render_stereo(&buffer[0], frames);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    state.counters["frames_per_second"] = benchmark::Counter(
+        static_cast<double>(frames), benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_MixerRenderVoices)->ArgName("voices")->Arg(1)->Arg(8)->Arg(32)->Arg(64);
+
+// Offline rendering of a busy 64 voice module, spread across a growing number of threads.
+// Zero threads is the inline mixing the real-time callback uses.
+static void BM_MixerRenderThreads(benchmark::State& state)
+{
+    const size_t voice_count = 64;
+    const size_t frames = 16384;
+    const auto samples = make_samples(16, 65536);
+
+    Mixer mixer(44100, voice_count);
+    mixer.set_samples_per_tick(882);
+    mixer.set_thread_count(static_cast<size_t>(state.range(0)));
+    play_voices(mixer, samples, voice_count);
+
+    std::vector<float> buffer(frames);
+    for (auto _ : state) {
+        mixer.render(&buffer[0], frames);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    state.counters["frames_per_second"] = benchmark::Counter(
+        static_cast<double>(frames), benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_MixerRenderThreads)
+    ->DenseRange(0, std::max(2, static_cast<int>(std::thread::hardware_concurrency())))
+    ->UseRealTime();
+
+// Interleaved stereo straight into the output against mono, for the same 64 voices
+static void BM_MixerRenderLayout(benchmark::State& state)
+{
+    const bool stereo = state.range(0) != 0;
+    const size_t voice_count = 64;
+    const size_t frames = 16384;
+    const auto samples = make_samples(16, 65536);
+
+    Mixer mixer(44100, voice_count);
+    mixer.set_samples_per_tick(882);
+    play_voices(mixer, samples, voice_count);
+    for (size_t c = 0; c < voice_count; ++c) {
+        mixer.channel(c).set_panning(static_cast<float>(c) / static_cast<float>(voice_count));
+    }
+
+    std::vector<float> buffer(frames * 2);
+    for (auto _ : state) {
+        if (stereo) {
+            mixer.render_stereo(&buffer[0], frames);
+        } else {
+            mixer.render(&buffer[0], frames);
+        }
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    state.counters["frames_per_second"] = benchmark::Counter(
+        static_cast<double>(frames), benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_MixerRenderLayout)->ArgName("stereo")->Arg(0)->Arg(1);
+
+// The float pipeline against the fixed point one, mixing the same 64 voices inline
+template <typename Mixing> static void BM_MixerRenderPipeline(benchmark::State& state)
+{
+    const size_t voice_count = 64;
+    const size_t frames = 16384;
+    const auto samples = make_samples(16, 65536);
+
+    BasicMixer<Mixing> mixer(44100, voice_count);
+    mixer.set_samples_per_tick(882);
+    play_voices(mixer, samples, voice_count);
+
+    std::vector<float> buffer(frames);
+    for (auto _ : state) {
+        mixer.render(&buffer[0], frames);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    state.counters["frames_per_second"] = benchmark::Counter(
+        static_cast<double>(frames), benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK_TEMPLATE(BM_MixerRenderPipeline, FloatMixing);
+BENCHMARK_TEMPLATE(BM_MixerRenderPipeline, FixedPointMixing);
+
+// A large offline render of the same 64 voices, mixed in blocks of a growing length. Ticks are
+// kept out of the way so only the block length bounds each mix.
+static void BM_MixerRenderBlockFrames(benchmark::State& state)
+{
+    const size_t voice_count = 64;
+    const size_t frames = 65536;
+    const auto samples = make_samples(16, 65536);
+
+    Mixer mixer(44100, voice_count);
+    mixer.set_samples_per_tick(frames);
+    mixer.set_block_frames(static_cast<size_t>(state.range(0)));
+    play_voices(mixer, samples, voice_count);
+
+    std::vector<float> buffer(frames * 2);
+    for (auto _ : state) {
+        mixer.render_stereo(&buffer[0], frames);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    state.counters["frames_per_second"] = benchmark::Counter(
+        static_cast<double>(frames), benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_MixerRenderBlockFrames)->ArgName("block")->RangeMultiplier(4)->Range(64, 65536);
@@ -0,0 +1,82 @@
+#include <benchmark/benchmark.h>
+
+#include <player/Module.h>
+#include <player/Player.h>
+#include <player/SeekIndex.h>
+#include <player/SongTimeline.h>
+
+#include <memory>
+#include <string>
+
+// A 32 channel pattern where `filled` channels play a note with an effect on every row, cycling
+// through the slides, vibratos, arpeggios and portamentos the effect ticks work hardest on. The
+// rest stay empty.
+static std::shared_ptr<Module> dense_module(uint8_t speed, size_t filled = 32)
+{
+    auto mod = std::make_shared<Module>();
+    mod->initial_speed = speed;
+    mod->initial_tempo = 125;
+    mod->patterns.resize(1, Pattern(64));
+    mod->patternOrder = {0, 255};
+    for (int s = 0; s < 4; ++s) {
+        mod->samples.emplace_back(
+            Sample{{0.5f, 1.0f, 0.5f, 1.0f, -0.5f, 0.25f, -1.0f, 0.0f}, 8363,
+                   {Sample::LoopParams::Type::forward_looping, 0, 8}});
+    }
+
+    const char* notes[] = {"C-5", "E-5", "G-5", "A#4"};
+    const char* effects[] = {"H44", "D04", "E02", "F02", "G08", "J37", "K04", "L04", "O01"};
+    std::string pattern;
+    for (size_t r = 0; r < 64; ++r) {
+        for (size_t c = 0; c < 32; ++c) {
+            if (c >= filled) {
+                pattern += "... .. .. .00 ";
+                continue;
+            }
+            pattern += std::string(notes[(r + c) % 4]) + " 0" + std::to_string(1 + c % 4) + " 48 " +
+                       effects[(r + c) % 9] + " ";
+        }
+        pattern += "\n";
+    }
+    parse_pattern(pattern, mod->patterns[0]);
+    return mod;
+}
+
+// One tick of the pattern per iteration. At speed 1 every tick starts a row; at higher speeds
+// most ticks only run the effects.
+static void BM_PlayerProcessTick(benchmark::State& state)
+{
+    Player player(dense_module(static_cast<uint8_t>(state.range(0)),
+                               static_cast<size_t>(state.range(1))));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(player.process_tick().data());
+    }
+    state.counters["ticks_per_second"] =
+        benchmark::Counter(1, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_PlayerProcessTick)->ArgNames({"speed", "filled"})->ArgsProduct({{1, 6}, {32, 4}});
+
+// A seek through the index to the middle of the dense pattern: restoring the nearest snapshot
+// and skipping the ticks after it
+static void BM_PlayerSeek(benchmark::State& state)
+{
+    const auto module = dense_module(6);
+    const SeekIndex index(module);
+    Player player(module);
+    const size_t frame = index.frames() / 2 + 441;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(index.seek(player, frame));
+    }
+}
+BENCHMARK(BM_PlayerSeek);
+
+// The whole dense pattern sequenced for its length and loop point, with nothing mixed
+static void BM_SongTimeline(benchmark::State& state)
+{
+    const auto module = dense_module(6);
+    for (auto _ : state) {
+        const SongTimeline timeline(module);
+        benchmark::DoNotOptimize(timeline.frames());
+    }
+}
+BENCHMARK(BM_SongTimeline);
@@ -1,10 +1,12 @@
 
 #include <player/Module.h>
 #include <player/PatternEntry.h>
+#include <player/Tracer.h>
 
 #include <algorithm>
 #include <array>
-#include <fstream>
+#include <iostream>
+#include <memory>
 
 template <typename T> static T read(std::istream& is)
 {
@@ -49,17 +51,19 @@ PatternEntry::Command it_comm_to_effect(const uint8_t comm)
     }
 }
 
-static Pattern load_pattern(std::ifstream& fs)
+// Decodes a pattern `channel_count` channels wide, widening it to every channel IT addresses
+// should it use more
+static Pattern load_pattern(std::istream& fs, size_t channel_count)
 {
     auto data_length = read<uint16_t>(fs);
     auto row_count = read<uint16_t>(fs);
     fs.seekg(4, std::ios::cur);
 
     std::vector<uint8_t> buffer(data_length);
-
-    Pattern pattern(row_count);
     fs.read(reinterpret_cast<char*>(&buffer[0]), data_length);
 
+    Pattern pattern(row_count, channel_count);
+
     std::array<uint8_t, 64> last_mask_variables;
     std::array<PatternEntry, 64> last_entries;
 
@@ -136,7 +140,10 @@ static Pattern load_pattern(std::ifstream& fs)
             entry.effect = last_entry.effect;
         }
 
-        pattern.channel(static_cast<size_t>(channel)).row(static_cast<size_t>(row)) = entry;
+        if (static_cast<size_t>(channel) >= pattern.channel_count()) {
+            pattern.set_channel_count(Pattern::max_channels);
+        }
+        pattern.entry(static_cast<size_t>(row), static_cast<size_t>(channel)) = entry;
         last_mask_variable = mask_variable;
         last_entry = entry;
     }
@@ -195,11 +202,12 @@ static Module::Sample load_sample(std::istream& is)
                           default_volume};
 }
 
-std::shared_ptr<Module> load_it(std::ifstream& it)
+std::shared_ptr<Module> load_it(std::istream& it)
 {
+    TraceSpan span("load_it");
     auto mod = std::make_shared<Module>();
 
-    if (!it.is_open()) {
+    if (!it) {
         std::cerr << "BAH!" << std::endl;
         return mod;
     }
@@ -210,12 +218,26 @@ std::shared_ptr<Module> load_it(std::ifstream& it)
     auto smp_num = read<uint16_t>(it);
     auto pat_num = read<uint16_t>(it);
 
+    it.seekg(0x2C);
+    const bool is_stereo = read<uint16_t>(it) & 0x01;
+
     it.seekg(0x32);
     // auto global_volume = read<uint8_t>(it);
     // auto mix_volume = read<uint8_t>(it);
     mod->initial_speed = read<uint8_t>(it);
     mod->initial_tempo = read<uint8_t>(it);
 
+    // 0-64 from left to right, 100 for surround (which we play centred) and +128 for a
+    // disabled channel
+    mod->channel_panning.resize(64, 32);
+    it.seekg(0x40);
+    for (auto& pan : mod->channel_panning) {
+        const auto setting = static_cast<uint8_t>(read<uint8_t>(it) & 0x7F);
+        if (is_stereo && setting <= 64) {
+            pan = static_cast<uint8_t>(setting);
+        }
+    }
+
     mod->patternOrder.resize(ord_num);
     it.seekg(0xc0);
     it.read(reinterpret_cast<char*>(&(mod->patternOrder[0])), ord_num);
@@ -231,19 +253,29 @@ std::shared_ptr<Module> load_it(std::ifstream& it)
 
     // We are skipping instruments for now
     for (const auto& pointer : smp_pointers) {
+        TraceSpan sample_span("decode sample", "sample", static_cast<int64_t>(mod->samples.size()));
         it.seekg(pointer);
         mod->samples.emplace_back(load_sample(it));
     }
 
+    // Each pattern starts out as wide as the widest so far, so the patterns of a song using the
+    // same channels throughout are decoded straight into place
+    size_t channel_count = Pattern::default_channels;
+    size_t widest = 0;
     for (const auto& pointer : pat_pointers) {
+        TraceSpan pattern_span("decode pattern", "pattern",
+                               static_cast<int64_t>(mod->patterns.size()));
         if (pointer == 0) {
             // A pointer of zero indicates an empty 64 row pattern
-            mod->patterns.emplace_back(64);
+            mod->patterns.emplace_back(64, channel_count);
         } else {
             it.seekg(pointer);
-            mod->patterns.emplace_back(load_pattern(it));
+            mod->patterns.emplace_back(load_pattern(it, channel_count));
+            widest = std::max(widest, mod->patterns.back().used_channel_count());
+            channel_count = std::max(widest, size_t{1});
         }
     }
+    mod->fit_channels();
 
     return mod;
 }
@@ -1,10 +1,10 @@
 #ifndef _LOADER_IT_
 #define _LOADER_IT_
 
-#include <fstream>
+#include <istream>
 #include <memory>
 
 struct Module;
-extern std::shared_ptr<Module> load_it(std::ifstream& fs);
+extern std::shared_ptr<Module> load_it(std::istream& fs);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,88 @@
+#include "module.h"
+#include "it.h"
+#include "s3m.h"
+
+#include <player/Module.h>
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <streambuf>
+
+// A read only, seekable stream buffer over memory someone else owns
+class MemoryBuffer : public std::streambuf {
+  public:
+    MemoryBuffer(const void* data, size_t size)
+    {
+        // streambuf only takes mutable pointers, but nothing here ever writes through them
+        auto begin = const_cast<char*>(static_cast<const char*>(data));
+        setg(begin, begin, begin + size);
+    }
+
+  protected:
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode) override
+    {
+        const off_type base = dir == std::ios_base::beg   ? 0
+                              : dir == std::ios_base::cur ? gptr() - eback()
+                                                          : egptr() - eback();
+        return seek(base + off);
+    }
+    pos_type seekpos(pos_type pos, std::ios_base::openmode) override
+    {
+        return seek(static_cast<off_type>(pos));
+    }
+
+  private:
+    pos_type seek(off_type pos)
+    {
+        if (pos < 0 || pos > egptr() - eback()) {
+            return pos_type(off_type(-1));
+        }
+        setg(eback(), eback() + pos, egptr());
+        return pos_type(pos);
+    }
+};
+
+std::shared_ptr<Module> load_module(const std::string& path)
+{
+    auto extension = std::filesystem::path(path).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](char c) { return static_cast<char>(std::tolower(c)); });
+
+    std::ifstream fs{path, std::ios::binary};
+    if (!fs) {
+        return nullptr;
+    }
+    if (extension == ".s3m") {
+        return load_module(fs, ModuleFormat::s3m);
+    } else if (extension == ".it") {
+        return load_module(fs, ModuleFormat::it);
+    }
+    return nullptr;
+}
+
+std::shared_ptr<Module> load_module(std::istream& is, ModuleFormat format)
+{
+    switch (format) {
+    case ModuleFormat::s3m:
+        return load_s3m(is);
+    case ModuleFormat::it:
+        return load_it(is);
+    }
+    return nullptr;
+}
+
+std::shared_ptr<Module> load_module(const void* data, size_t size, ModuleFormat format)
+{
+    MemoryBuffer buffer(data, size);
+    std::istream is(&buffer);
+    return load_module(is, format);
+}
+
+bool is_playable(const Module& module)
+{
+    const auto& order = module.patternOrder;
+    return module.initial_speed > 0 && !order.empty() && order[0] < module.patterns.size() &&
+           std::find(order.begin(), order.end(), 255) != order.end();
+}
@@ -0,0 +1,23 @@
+#ifndef _LOADER_MODULE_
+#define _LOADER_MODULE_
+
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <string>
+
+struct Module;
+
+enum class ModuleFormat { s3m, it };
+
+// Loads an .it or .s3m file, picking the loader by the file's extension. Returns nullptr for
+// any other kind of file, or one that can't be opened.
+extern std::shared_ptr<Module> load_module(const std::string& path);
+extern std::shared_ptr<Module> load_module(std::istream& is, ModuleFormat format);
+// Loads a module straight out of `size` bytes at `data`, without copying them first
+extern std::shared_ptr<Module> load_module(const void* data, size_t size, ModuleFormat format);
+// Whether a Player can play `module`: it has an end of song marker, its first order is a
+// pattern it has, and it starts at a speed that moves on to another row
+extern bool is_playable(const Module& module);
+
+#endif
@@ -1,12 +1,13 @@
 #include <algorithm>
 #include <cinttypes>
 #include <cstdlib>
-#include <fstream>
 #include <iostream>
+#include <memory>
 
 #include <player/Module.h>
 #include <player/PatternEntry.h>
 #include <player/Sample.h>
+#include <player/Tracer.h>
 
 template <typename T> T read(std::istream& is)
 {
@@ -40,7 +41,7 @@ static float convert(const uint16_t word)
     return static_cast<float>(word) / 65535.0f * 2.0f - 1.0f;
 }
 
-Module::Sample load_sample(std::ifstream& fs)
+Module::Sample load_sample(std::istream& fs)
 {
     InstrumentMetaData meta;
 
@@ -103,9 +104,9 @@ PatternEntry::Command s3m_comm_to_effect(const uint8_t comm)
     }
 }
 
-Pattern load_pattern(std::ifstream& fs)
+Pattern load_pattern(std::istream& fs)
 {
-    Pattern pattern(64);
+    Pattern pattern(64, 32);
     auto data_length = read<uint16_t>(fs);
     std::vector<uint8_t> buffer(data_length);
 
@@ -155,16 +156,17 @@ Pattern load_pattern(std::ifstream& fs)
             }
             entry.effect = PatternEntry::Effect{command, info};
         }
-        pattern.channel(static_cast<size_t>(channel)).row(static_cast<size_t>(row)) = entry;
+        pattern.entry(static_cast<size_t>(row), static_cast<size_t>(channel)) = entry;
     }
     return pattern;
 }
 
-std::shared_ptr<Module> load_s3m(std::ifstream& s3m)
+std::shared_ptr<Module> load_s3m(std::istream& s3m)
 {
+    TraceSpan span("load_s3m");
     auto mod = std::make_shared<Module>();
 
-    if (!s3m.is_open()) {
+    if (!s3m) {
         std::cerr << "BAH!" << std::endl;
         return mod;
     }
@@ -177,6 +179,13 @@ std::shared_ptr<Module> load_s3m(std::ifstream& s3m)
     s3m.seekg(0x31);
     mod->initial_speed = read<uint8_t>(s3m);
     mod->initial_tempo = read<uint8_t>(s3m);
+    const bool is_stereo = read<uint8_t>(s3m) & 0x80;
+    s3m.seekg(0x35);
+    const bool has_pan_table = read<uint8_t>(s3m) == 252;
+
+    std::vector<uint8_t> channel_settings(32);
+    s3m.seekg(0x40);
+    s3m.read(reinterpret_cast<char*>(&channel_settings[0]), 32);
 
     mod->patternOrder.resize(ord_num);
     s3m.seekg(0x60);
@@ -191,17 +200,37 @@ std::shared_ptr<Module> load_s3m(std::ifstream& s3m)
     pattern_pointers.resize(pat_num);
     s3m.read(reinterpret_cast<char*>(&pattern_pointers[0]), sizeof(pattern_pointers[0]) * pat_num);
 
+    // Channels 0-7 are the left ones and 8-15 the right, unless the pan table that follows the
+    // pattern pointers sets a position (0-15) of their own
+    std::vector<uint8_t> pan_table(32);
+    if (has_pan_table) {
+        s3m.read(reinterpret_cast<char*>(&pan_table[0]), 32);
+    }
+    mod->channel_panning.resize(32, 32);
+    for (size_t c = 0; is_stereo && c < 32; ++c) {
+        const auto type = channel_settings[c] & 0x7F;
+        int pan = type < 8 ? 3 : 12;
+        if (pan_table[c] & 0x20) {
+            pan = pan_table[c] & 0x0F;
+        }
+        mod->channel_panning[c] = static_cast<uint8_t>((pan * 64 + 7) / 15);
+    }
+
     // Load Samples
     for (const auto pointer : instrument_pointers) {
+        TraceSpan sample_span("decode sample", "sample", static_cast<int64_t>(mod->samples.size()));
         s3m.seekg(pointer * 16);
         mod->samples.emplace_back(load_sample(s3m));
     }
 
     // Load Patterns
     for (const auto pointer : pattern_pointers) {
+        TraceSpan pattern_span("decode pattern", "pattern",
+                               static_cast<int64_t>(mod->patterns.size()));
         s3m.seekg(pointer * 16);
         mod->patterns.emplace_back(load_pattern(s3m));
     }
+    mod->fit_channels();
 
     return mod;
 }
\ No newline at end of file
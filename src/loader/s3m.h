@@ -1,10 +1,10 @@
 #ifndef _LOADER_S3M_
 #define _LOADER_S3M_
 
-#include <fstream>
+#include <istream>
 #include <memory>
 
 struct Module;
-extern std::shared_ptr<Module> load_s3m(std::ifstream& s3m);
+extern std::shared_ptr<Module> load_s3m(std::istream& s3m);
 
 #endif
\ No newline at end of file
@@ -1,21 +1,64 @@
 #include <portaudio.h>
 
+#include <player/BatchRender.h>
 #include <player/Module.h>
+#include <player/OfflineRenderer.h>
+#include <player/PerfCounters.h>
 #include <player/Player.h>
+#include <player/RenderAhead.h>
+#include <player/SeekIndex.h>
+#include <player/SongTimeline.h>
+#include <player/Tracer.h>
 
-#include <loader/it.h>
-#include <loader/s3m.h>
+#include <loader/module.h>
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
 #include <vector>
 
+struct Playback {
+    Player& player;
+    // Set when rendering ahead, in which case the callback only copies frames out of it
+    std::unique_ptr<RenderAhead> render_ahead;
+    // Set when collecting performance counters
+    std::unique_ptr<PerfCounters> perf_counters;
+};
+
 static int patestCallback(const void*, void* outputBuffer, unsigned long framesPerBuffer,
-                          const PaStreamCallbackTimeInfo*, PaStreamCallbackFlags, void* userData)
+                          const PaStreamCallbackTimeInfo*, PaStreamCallbackFlags statusFlags,
+                          void* userData)
 {
-    auto player = reinterpret_cast<Player*>(userData);
+    auto playback = reinterpret_cast<Playback*>(userData);
+    auto perf_counters = playback->perf_counters.get();
+    const auto start = perf_counters ? std::chrono::steady_clock::now()
+                                     : std::chrono::steady_clock::time_point();
     auto pOut = reinterpret_cast<float*>(outputBuffer);
-    player->render_audio(pOut, static_cast<int>(framesPerBuffer));
+    if (playback->render_ahead) {
+        playback->render_ahead->read(pOut, framesPerBuffer);
+    } else {
+        playback->player.render_stereo_audio(pOut, static_cast<int>(framesPerBuffer));
+    }
+
+    if (perf_counters) {
+        if (statusFlags & paOutputUnderflow) {
+            perf_counters->record_underflow();
+        }
+        if (statusFlags & paOutputOverflow) {
+            perf_counters->record_overflow();
+        }
+        const auto deadline = std::chrono::nanoseconds(
+            framesPerBuffer * 1000000000UL / playback->player.mixer().sampling_rate());
+        perf_counters->record_callback(std::chrono::steady_clock::now() - start, deadline);
+    }
 
     return paContinue;
 }
@@ -26,36 +69,252 @@ static void StreamFinished(void* userData)
     std::cout << "Stream complete" << std::endl;
 }
 
-static std::shared_ptr<Module> load_module(const char* filename)
+// Reads commands from stdin and hands them to the audio thread, until "q" or end of input
+static void run_controls(Playback& playback)
+{
+    auto& player = playback.player;
+    bool paused = false;
+    std::vector<bool> muted(player.channels.size());
+    std::vector<bool> soloed(player.channels.size());
+    auto send = [&](const PlayerCommand::Action& action) {
+        if (!player.send(action)) {
+            std::cerr << "Command dropped, the player is not keeping up" << std::endl;
+        }
+    };
+
+    std::string command;
+    while (std::cin >> command && command != "q") {
+        size_t channel = 0;
+        if (command == "p") {
+            paused = !paused;
+            send(PlayerCommand::Pause{paused});
+        } else if (command == "g") {
+            size_t order = 0;
+            size_t row = 0;
+            if (std::cin >> order >> row) {
+                send(PlayerCommand::Seek{order, row});
+            }
+        } else if (command == "j") {
+            double seconds = 0;
+            if (std::cin >> seconds) {
+                send(PlayerCommand::SeekTime{seconds});
+            }
+        } else if (command == "t") {
+            int tempo = 0;
+            if (std::cin >> tempo) {
+                send(PlayerCommand::SetTempo{tempo});
+            }
+        } else if (command == "m" && std::cin >> channel && channel - 1 < muted.size()) {
+            muted[channel - 1] = !muted[channel - 1];
+            send(PlayerCommand::Mute{channel - 1, muted[channel - 1]});
+        } else if (command == "s" && std::cin >> channel && channel - 1 < soloed.size()) {
+            soloed[channel - 1] = !soloed[channel - 1];
+            send(PlayerCommand::Solo{channel - 1, soloed[channel - 1]});
+        } else if (command == "v") {
+            float volume = 0;
+            if (std::cin >> volume) {
+                send(PlayerCommand::SetMasterVolume{volume / 100.0f});
+            }
+        } else if (command == "l") {
+            std::cout << "Last command took " << player.command_latency().count() / 1000
+                      << " us, the slowest " << player.max_command_latency().count() / 1000
+                      << " us" << std::endl;
+            if (playback.render_ahead) {
+                std::cout << playback.render_ahead->fill_level() << " of "
+                          << playback.render_ahead->lookahead_frames()
+                          << " frames rendered ahead, "
+                          << playback.render_ahead->underruns() << " underruns" << std::endl;
+            }
+        } else if (command == "c") {
+            if (playback.perf_counters) {
+                std::cout << playback.perf_counters->snapshot();
+            } else {
+                std::cout << "Performance counters are off, run with --stats" << std::endl;
+            }
+        }
+        std::cin.clear();
+    }
+}
+
+static void report_throughput(double frames, double elapsed, unsigned int sample_rate)
+{
+    std::cout << frames / sample_rate << " s of audio in " << elapsed << " s: " << frames / elapsed
+              << " frames/s, " << frames / sample_rate / elapsed << "x realtime" << std::endl;
+}
+
+// Renders to a WAV file as fast as the CPU allows, and reports the throughput
+static int render_to_file(Player& player, const char* path, double seconds)
+{
+    std::vector<char> file_buffer(1 << 20);
+    std::ofstream file;
+    file.rdbuf()->pubsetbuf(file_buffer.data(), static_cast<std::streamsize>(file_buffer.size()));
+    file.open(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Error: can't write " << path << std::endl;
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const size_t frames = render_to_wav(player, file, seconds);
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << "Rendered ";
+    report_throughput(static_cast<double>(frames), elapsed.count(),
+                      player.mixer().sampling_rate());
+    return file ? 0 : 1;
+}
+
+// Reports how long each module named plays before it loops, and where it loops back to,
+// without rendering any of it
+static int report_lengths(const std::vector<std::string>& inputs)
 {
-    std::ifstream fs{filename, std::ios::binary};
-    char ext[5];
+    int failures = 0;
+    for (const auto& input : inputs) {
+        const auto module = load_module(input);
+        if (!module || !is_playable(*module)) {
+            std::cout << input << ": can't play" << std::endl;
+            ++failures;
+            continue;
+        }
+        const SongTimeline timeline(module);
+        std::cout << input << ": " << timeline.seconds() << " s, " << timeline.frames()
+                  << " frames, " << timeline.rows().size() << " rows, ";
+        if (const auto loop = timeline.loop()) {
+            std::cout << "loops to order " << loop->order << " row " << loop->row << " at "
+                      << timeline.seconds_at(loop->frame) << " s" << std::endl;
+        } else {
+            std::cout << "doesn't loop" << std::endl;
+        }
+    }
+    return failures ? 1 : 0;
+}
 
-    const char* ptr = filename;
-    while (*ptr != '.' && *ptr != '\0')
-        ptr++;
-    std::strncpy(ext, ptr, 4);
-    for (size_t i = 0; i < strnlen(ext, 4); ++i) {
-        ext[i] = static_cast<char>(std::tolower(ext[i]));
+// Renders every module named, or found in a directory named, to a WAV file of the same name in
+// `output_dir`, on `thread_count` threads
+static int render_batch_to_dir(const std::vector<std::string>& inputs, const char* output_dir,
+                               size_t thread_count, double seconds)
+{
+    namespace fs = std::filesystem;
+    std::vector<BatchJob> jobs;
+    auto add_job = [&](const fs::path& module_path) {
+        const auto output = fs::path(output_dir) / module_path.stem().concat(".wav");
+        jobs.push_back({module_path.string(), output.string()});
+    };
+    for (const auto& input : inputs) {
+        if (fs::is_directory(input)) {
+            for (const auto& entry : fs::directory_iterator(input)) {
+                if (entry.is_regular_file()) {
+                    add_job(entry.path());
+                }
+            }
+        } else {
+            add_job(input);
+        }
     }
+    fs::create_directories(output_dir);
 
-    if (strncmp(ext, ".s3m", 4) == 0) {
-        return load_s3m(fs);
-    } else if (strncmp(ext, ".it", 4) == 0) {
-        return load_it(fs);
+    const auto start = std::chrono::steady_clock::now();
+    const auto results = render_batch(jobs, thread_count, seconds);
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    size_t frames = 0;
+    size_t failures = 0;
+    unsigned int sample_rate = 0;
+    for (const auto& result : results) {
+        if (result.ok()) {
+            std::cout << result.module_path << ": " << result.seconds << " s" << std::endl;
+            frames += result.frames;
+            sample_rate = result.sample_rate;
+        } else {
+            std::cout << result.module_path << ": failed after " << result.seconds << " s, "
+                      << result.error << std::endl;
+            ++failures;
+        }
+    }
+    std::cout << results.size() - failures << " of " << results.size() << " modules on "
+              << thread_count << " threads rendered";
+    if (sample_rate) {
+        std::cout << " ";
+        report_throughput(static_cast<double>(frames), elapsed.count(), sample_rate);
     } else {
-        return std::make_shared<Module>();
+        std::cout << std::endl;
     }
+    return failures ? 1 : 0;
 }
 
 int main(int argc, char* argv[])
 {
-
-    if (argc < 2) {
+    // --lookahead <ms> renders on a thread of its own, that far ahead of the audio callback.
+    // --render <file.wav> renders to a file instead of playing, for --seconds <n> or to the
+    // end of the song. --batch <dir> does the same for every module named, or in a directory
+    // named, on --threads <n> threads. --stats collects performance counters while playing.
+    // --trace <file.json> writes a Chrome trace of loading, ticks, renders and voices.
+    // --length reports how long each module named plays and where it loops, without playing.
+    std::vector<std::string> inputs;
+    const char* render_path = nullptr;
+    const char* batch_dir = nullptr;
+    const char* trace_path = nullptr;
+    double seconds = 0;
+    int lookahead_ms = 0;
+    bool stats = false;
+    bool lengths = false;
+    size_t thread_count = std::max(1U, std::thread::hardware_concurrency());
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--lookahead") == 0 && i + 1 < argc) {
+            lookahead_ms = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--render") == 0 && i + 1 < argc) {
+            render_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--stats") == 0) {
+            stats = true;
+        } else if (std::strcmp(argv[i], "--length") == 0) {
+            lengths = true;
+        } else if (std::strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+            batch_dir = argv[++i];
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            thread_count = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+        } else {
+            inputs.push_back(argv[i]);
+        }
+    }
+    if (inputs.empty()) {
         std::cout << "S3M filename please" << std::endl;
         exit(1);
     }
 
+    // Declared ahead of everything it traces, so it outlives them
+    std::ofstream trace_file;
+    std::unique_ptr<Tracer> tracer;
+    if (trace_path) {
+        trace_file.open(trace_path);
+        if (!trace_file) {
+            std::cerr << "Error: can't write " << trace_path << std::endl;
+            return 1;
+        }
+        tracer = std::make_unique<Tracer>(trace_file);
+        tracer->install();
+    }
+
+    if (lengths) {
+        return report_lengths(inputs);
+    }
+    if (batch_dir) {
+        return render_batch_to_dir(inputs, batch_dir, thread_count, seconds);
+    }
+
+    const auto module = load_module(inputs.front());
+    if (!module || !is_playable(*module)) {
+        std::cerr << "Error: can't play " << inputs.front() << std::endl;
+        return 1;
+    }
+    if (render_path) {
+        Player player(module);
+        return render_to_file(player, render_path, seconds);
+    }
+
     PaError err;
     err = Pa_Initialize();
     if (err != paNoError) {
@@ -68,17 +327,27 @@ int main(int argc, char* argv[])
         std::cerr << "Error: No default output device" << std::endl;
         return 1;
     }
-    outputParameters.channelCount = 1;
+    outputParameters.channelCount = 2;
     outputParameters.sampleFormat = paFloat32;
     outputParameters.suggestedLatency =
         Pa_GetDeviceInfo(outputParameters.device)->defaultHighOutputLatency;
     outputParameters.hostApiSpecificStreamInfo = NULL;
 
-    Player player(load_module(argv[1]));
+    Player player(module);
+    player.set_seek_index(std::make_shared<const SeekIndex>(module));
+    Playback playback{player, nullptr, nullptr};
+    if (stats) {
+        playback.perf_counters = std::make_unique<PerfCounters>();
+        player.set_perf_counters(playback.perf_counters.get());
+    }
+    if (lookahead_ms > 0) {
+        playback.render_ahead = std::make_unique<RenderAhead>(
+            player, static_cast<size_t>(lookahead_ms) * player.mixer().sampling_rate() / 1000);
+    }
 
     PaStream* stream = nullptr;
     err = Pa_OpenStream(&stream, NULL, &outputParameters, 44100, paFramesPerBufferUnspecified, 0,
-                        patestCallback, reinterpret_cast<void*>(&player));
+                        patestCallback, reinterpret_cast<void*>(&playback));
     if (err != paNoError) {
         std::cerr << "Error opening stream" << std::endl;
         return 1;
@@ -87,13 +356,22 @@ int main(int argc, char* argv[])
     Pa_SetStreamFinishedCallback(stream, StreamFinished);
     Pa_StartStream(stream);
 
-    std::cout << "Press any key to quit" << std::endl;
-    std::cin.get();
+    std::cout << "p: pause/resume, g <order> <row>: seek, j <seconds>: jump, t <tempo>: tempo,\n"
+                 "m <channel>: mute/unmute, s <channel>: solo/unsolo, v <0-100>: volume,\n"
+                 "l: command latency, c: performance counters, q: quit"
+              << std::endl;
+    run_controls(playback);
 
     Pa_StopStream(stream);
     Pa_CloseStream(stream);
+    if (playback.perf_counters) {
+        std::cout << playback.perf_counters->snapshot();
+    }
 
     Pa_Terminate();
+    if (tracer && tracer->dropped()) {
+        std::cerr << tracer->dropped() << " trace spans dropped" << std::endl;
+    }
     std::cout << "Completed" << std::endl;
 
     return 0;
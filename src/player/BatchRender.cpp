@@ -0,0 +1,65 @@
+#include "BatchRender.h"
+#include "Module.h"
+#include "OfflineRenderer.h"
+#include "Player.h"
+#include "WorkerPool.h"
+
+#include <loader/module.h>
+
+#include <chrono>
+#include <exception>
+#include <fstream>
+
+static void load_and_render(const BatchJob& job, BatchResult& result, double seconds)
+{
+    if (!std::ifstream(job.module_path)) {
+        result.error = "can't open the module";
+        return;
+    }
+    const auto module = load_module(job.module_path);
+    if (!module) {
+        result.error = "not an .it or .s3m module";
+        return;
+    }
+    if (!is_playable(*module)) {
+        result.error = "nothing to play";
+        return;
+    }
+    std::ofstream output(job.output_path, std::ios::binary);
+    if (!output) {
+        result.error = "can't write " + job.output_path;
+        return;
+    }
+
+    Player player(module);
+    result.sample_rate = player.mixer().sampling_rate();
+    result.frames = render_to_wav(player, output, seconds);
+    if (!output) {
+        result.error = "failed writing " + job.output_path;
+    }
+}
+
+static void render_job(const BatchJob& job, BatchResult& result, double seconds)
+{
+    const auto start = std::chrono::steady_clock::now();
+    result.module_path = job.module_path;
+    // A malformed module can throw from the loader or the player, bad_alloc for a garbage
+    // sample length say. That fails its own job, not the whole batch.
+    try {
+        load_and_render(job, result, seconds);
+    } catch (const std::exception& e) {
+        result.error = e.what();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    result.seconds = elapsed.count();
+}
+
+std::vector<BatchResult> render_batch(const std::vector<BatchJob>& jobs, size_t thread_count,
+                                      double seconds)
+{
+    std::vector<BatchResult> results(jobs.size());
+    WorkerPool pool(thread_count);
+    auto task = [&](size_t i) { render_job(jobs[i], results[i], seconds); };
+    pool.run(jobs.size(), task);
+    return results;
+}
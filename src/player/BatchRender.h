@@ -0,0 +1,32 @@
+#ifndef _PLAYER_BATCH_RENDER_H_
+#define _PLAYER_BATCH_RENDER_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+struct BatchJob {
+    std::string module_path;
+    std::string output_path;
+};
+
+struct BatchResult {
+    std::string module_path;
+    // Why the module didn't render, empty when it did
+    std::string error;
+    size_t frames = 0;
+    unsigned int sample_rate = 0;
+    // Time taken over the job, failed or not
+    double seconds = 0;
+
+    bool ok() const { return error.empty(); }
+};
+
+// Renders each job's module to a WAV file, as render_to_wav() does, spreading the jobs over
+// `thread_count` threads. Every job loads its own Module into its own Player, so jobs share
+// nothing, and an idle thread takes the next job as soon as it finishes its last. A job that
+// throws fails with the exception's message. Results come back in job order.
+extern std::vector<BatchResult> render_batch(const std::vector<BatchJob>& jobs,
+                                             size_t thread_count, double seconds = 0);
+
+#endif
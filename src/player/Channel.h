@@ -1,36 +1,44 @@
 #ifndef _CHANNEL_H_
 #define _CHANNEL_H_
 
+#include "FixedPointMixing.h"
+#include "FloatMixing.h"
 #include "Sample.h"
+#include "VoiceSet.h"
 
+#include <algorithm>
 #include <cstring>
 #include <variant>
 
-class Channel {
-  public:
-    struct Event {
-        struct SetFrequency {
-            float frequency;
-            bool operator==(const SetFrequency& rhs) const { return frequency == rhs.frequency; }
-        };
-        struct SetNoteOn {
-            float frequency;
-            const Sample* sample;
-            bool operator==(const SetNoteOn& rhs) const
-            {
-                return sample == rhs.sample && frequency == rhs.frequency;
-            }
-        };
-        struct SetSampleIndex {
-            int index;
-            bool operator==(const SetSampleIndex& rhs) const { return index == rhs.index; }
-        };
-        struct SetVolume {
-            float volume;
-            bool operator==(const SetVolume& rhs) const { return volume == rhs.volume; }
-        };
-        using Action = std::variant<SetFrequency, SetNoteOn, SetSampleIndex, SetVolume>;
+// Events are the same whichever way a channel mixes, so one Player can drive any of them
+struct ChannelEvent {
+    struct SetFrequency {
+        float frequency;
+        bool operator==(const SetFrequency& rhs) const { return frequency == rhs.frequency; }
+    };
+    struct SetNoteOn {
+        float frequency;
+        const Sample* sample;
+        bool operator==(const SetNoteOn& rhs) const
+        {
+            return sample == rhs.sample && frequency == rhs.frequency;
+        }
     };
+    struct SetSampleIndex {
+        int index;
+        bool operator==(const SetSampleIndex& rhs) const { return index == rhs.index; }
+    };
+    struct SetVolume {
+        float volume;
+        bool operator==(const SetVolume& rhs) const { return volume == rhs.volume; }
+    };
+    using Action = std::variant<SetFrequency, SetNoteOn, SetSampleIndex, SetVolume>;
+};
+
+template <typename Mixing> class BasicChannel {
+  public:
+    using Event = ChannelEvent;
+    using Accumulator = typename Mixing::Accumulator;
 
   public:
     void process_event(const Event::Action& action)
@@ -50,21 +58,30 @@ class Channel {
                 c.set_sample_index(set_index.index);
             }
             void operator()(const Event::SetVolume& set_vol) { c.set_volume(set_vol.volume); }
-            Channel& c;
+            BasicChannel& c;
         };
         std::visit(ActionInterpreter{*this}, action);
     }
 
     bool is_active() const { return _is_active; }
 
+    // Keeps `voices` up to date with whether this channel, voice number `index`, is playing.
+    void attach(VoiceSet* voices, size_t index)
+    {
+        _voices = voices;
+        _voice_index = index;
+        set_active(_is_active);
+    }
+
     void play(const Sample* sample)
     {
         set_sample(sample);
         _sampleIndex = 0;
-        _is_active = true;
+        _laps = 0;
+        set_active(true);
     }
 
-    void stop() { _is_active = false; }
+    void stop() { set_active(false); }
 
     void set_sample(const Sample* sample_) { _sample = sample_; }
 
@@ -74,52 +91,250 @@ class Channel {
             return;
         if (static_cast<size_t>(index) >= _sample->length())
             return;
-        _sampleIndex = static_cast<float>(index);
+        _sampleIndex = Mixing::frames(static_cast<size_t>(index));
     }
 
     void set_frequency(const float freq) { _frequency = freq; }
 
     void set_volume(const float vol) { _volume = vol; }
 
-    void render(float* outputBuffer, unsigned long framesPerBuffer,
+    // 0 is hard left, 0.5 (the default) the centre and 1 hard right. Each side keeps full gain
+    // until the voice pans away from it, so a centred voice is as loud on both sides as it is
+    // in mono.
+    void set_panning(const float panning) { _panning = std::clamp(panning, 0.0f, 1.0f); }
+
+    void render(Accumulator* outputBuffer, unsigned long framesPerBuffer,
                 const unsigned int targetSampleRate)
     {
+        std::memset(outputBuffer, 0, framesPerBuffer * sizeof outputBuffer[0]);
+        mix(outputBuffer, framesPerBuffer, targetSampleRate);
+    }
 
-        float rate = _frequency / static_cast<float>(targetSampleRate);
+    // Adds this channel's output to what is already in outputBuffer. An idle channel leaves it
+    // untouched.
+    void mix(Accumulator* outputBuffer, unsigned long framesPerBuffer,
+             const unsigned int targetSampleRate,
+             const Interpolation interpolation = Interpolation::linear)
+    {
+        mix_voice(outputBuffer, framesPerBuffer, targetSampleRate, interpolation,
+                  Mixing::mono_gain(_volume));
+    }
+
+    // As mix(), into interleaved left/right frames, placed by the channel's panning
+    void mix_stereo(Accumulator* outputBuffer, unsigned long framesPerBuffer,
+                    const unsigned int targetSampleRate,
+                    const Interpolation interpolation = Interpolation::linear)
+    {
+        mix_voice(outputBuffer, framesPerBuffer, targetSampleRate, interpolation,
+                  Mixing::stereo_gain(_volume * left_gain(), _volume * right_gain()));
+    }
+
+    template <typename Gain>
+    void mix_voice(Accumulator* outputBuffer, unsigned long framesPerBuffer,
+                   const unsigned int targetSampleRate, const Interpolation interpolation,
+                   const Gain gain)
+    {
         if (!is_active() || _sample == nullptr) {
-            std::memset(outputBuffer, 0, framesPerBuffer * sizeof outputBuffer[0]);
             return;
         }
-        for (; framesPerBuffer; --framesPerBuffer) {
-            if (static_cast<size_t>(_sampleIndex) >= _sample->loopEnd()) {
-                if (_sample->loopType() == Sample::LoopParams::Type::non_looping) {
-                    // If we're done with this sample fill the rest with zeros
-                    std::memset(outputBuffer, 0, framesPerBuffer * sizeof(outputBuffer[0]));
-                    // Stop playback on this channel
+        const auto rate = Mixing::rate(_frequency, targetSampleRate);
+        const auto kernel = Mixing::template kernel<Gain>(interpolation);
+        const auto taps = interpolation_taps(interpolation);
+        const bool short_loop = is_looping() && _sample->loopLength() < edge_window_frames / 2;
+        while (framesPerBuffer) {
+            const auto whole = Mixing::whole(_sampleIndex);
+            if (whole >= _sample->loopEnd()) {
+                if (!is_looping()) {
+                    // We're done with this sample, so stop playback on this channel
                     stop();
                     // and do no more.
                     break;
                 }
-                _sampleIndex -= static_cast<float>(_sample->loopLength());
+                // A span may have gone round a short loop several times
+                const size_t laps = (whole - _sample->loopEnd()) / _sample->loopLength() + 1;
+                _sampleIndex -= Mixing::frames(laps * _sample->loopLength());
+                _laps = std::min(_laps + laps, max_laps);
+            }
+            // Frames up to the wrap go to the kernel straight from the sample data. Short loops,
+            // and frames reaching back past the loop start into earlier laps, go to the same
+            // kernel from a window stitched together the way the sample reads across its edges.
+            // Either way the span length is worked out up front and rendered with no per frame
+            // checks.
+            unsigned long span = 0;
+            if (!short_loop) {
+                span = std::min(static_cast<unsigned long>(frames_clear_of_edges(rate, taps)),
+                                framesPerBuffer);
+            }
+            if (span) {
+                _sampleIndex =
+                    kernel(outputBuffer, span, Mixing::data(*_sample), _sampleIndex, rate, gain);
+            } else {
+                span = mix_edge(outputBuffer, framesPerBuffer, rate, taps, kernel, gain);
+            }
+            outputBuffer += span * Gain::channels;
+            framesPerBuffer -= span;
+        }
+    }
+
+    // Moves the voice on by `frames` frames without mixing them. It lands where mixing them
+    // would, stopping at the end of a one shot and going round a loop.
+    void advance(size_t frames, const unsigned int targetSampleRate)
+    {
+        if (!is_active() || _sample == nullptr) {
+            return;
+        }
+        _sampleIndex += Mixing::rate(_frequency, targetSampleRate) *
+                        static_cast<typename Mixing::Position>(frames);
+        const auto whole = Mixing::whole(_sampleIndex);
+        if (whole >= _sample->loopEnd()) {
+            if (!is_looping()) {
+                stop();
+                return;
             }
-            *outputBuffer++ = (*_sample)[_sampleIndex] * _volume;
-            _sampleIndex += rate;
+            const size_t laps = (whole - _sample->loopEnd()) / _sample->loopLength() + 1;
+            _sampleIndex -= Mixing::frames(laps * _sample->loopLength());
+            _laps = std::min(_laps + laps, max_laps);
         }
     }
 
     float frequency() const { return _frequency; }
     const Sample* sample() const { return _sample; }
-    float sample_index() const { return _sampleIndex; }
+    float sample_index() const { return Mixing::index(_sampleIndex); }
     float volume() const { return _volume; }
+    float panning() const { return _panning; }
+    float left_gain() const { return std::min(1.0f, 2.0f * (1.0f - _panning)); }
+    float right_gain() const { return std::min(1.0f, 2.0f * _panning); }
+
+  private:
+    void set_active(bool active)
+    {
+        _is_active = active;
+        if (_voices == nullptr)
+            return;
+        if (active) {
+            _voices->insert(_voice_index);
+        } else {
+            _voices->erase(_voice_index);
+        }
+    }
+
+    // Frames from the current one whose positions fall below `limit`
+    size_t frames_before(typename Mixing::Position limit, typename Mixing::Position rate) const
+    {
+        if (rate <= 0 || limit <= _sampleIndex) {
+            return 0;
+        }
+        const auto distance = limit - _sampleIndex;
+        auto count = static_cast<size_t>(distance / rate);
+        if (rate * static_cast<typename Mixing::Position>(count) < distance) {
+            ++count;
+        }
+        return count;
+    }
+
+    static_assert(interpolation_taps(Interpolation::sinc16).before <= Sample::guard_frames &&
+                      interpolation_taps(Interpolation::sinc16).after <= Sample::guard_frames,
+                  "Sample guard frames must cover the widest interpolator");
+
+    // The sample's guard frames give every position up to the wrap all of its taps. Only once
+    // looped do the taps before the loop start need the earlier laps the window supplies.
+    size_t frames_clear_of_edges(typename Mixing::Position rate, InterpolationTaps taps) const
+    {
+        if (_laps && _sampleIndex < Mixing::frames(_sample->loopBegin() + taps.before)) {
+            return 0;
+        }
+        return frames_before(Mixing::frames(_sample->loopEnd()), rate);
+    }
+
+    bool is_looping() const
+    {
+        return _sample->loopType() == Sample::LoopParams::Type::forward_looping &&
+               _sample->loopLength() != 0;
+    }
+
+    static constexpr size_t edge_window_frames = 64;
+    // Laps past this many reach back further than any interpolator's taps
+    static constexpr size_t max_laps = 16;
+
+    // Renders at least one and at most `frames` frames through a window holding the frames the
+    // sample reads from around the current position, as if the loop were written out: silence
+    // before the start, earlier laps before the loop start, the loop repeated past the loop end,
+    // or silence past the end of a one shot. A window over a short loop spans several laps.
+    // Returns how many frames it rendered.
+    template <typename Kernel, typename Gain>
+    size_t mix_edge(Accumulator* outputBuffer, size_t frames, typename Mixing::Position rate,
+                    InterpolationTaps taps, Kernel kernel, const Gain gain)
+    {
+        const size_t loop_end = _sample->loopEnd();
+        const size_t whole = Mixing::whole(_sampleIndex);
+        const long first = static_cast<long>(whole) - static_cast<long>(taps.before);
+        const size_t length =
+            is_looping() ? edge_window_frames
+                         : std::min(edge_window_frames,
+                                    loop_end - whole + taps.before + taps.after);
+
+        typename Mixing::Frame window[edge_window_frames];
+        const auto* data = Mixing::data(*_sample);
+        size_t i = 0;
+        auto index = first;
+        if (_laps && index < static_cast<long>(_sample->loopBegin())) {
+            // Where the window starts with the loop written out, folded back into the loop
+            const auto loop_length = static_cast<long>(_sample->loopLength());
+            index += static_cast<long>(_laps) * loop_length;
+            if (index >= static_cast<long>(loop_end)) {
+                index = static_cast<long>(_sample->loopBegin()) +
+                        (index - static_cast<long>(loop_end)) % loop_length;
+            }
+        }
+        for (; i < length && index < 0; ++i, ++index) {
+            window[i] = 0;
+        }
+        for (; i < length; ++i, ++index) {
+            if (index == static_cast<long>(loop_end)) {
+                if (!is_looping()) {
+                    break;
+                }
+                index = static_cast<long>(_sample->loopBegin());
+            }
+            window[i] = data[index];
+        }
+        for (; i < length; ++i) {
+            window[i] = 0;
+        }
+
+        // Positions are rebased to the window, which is exact: `first` is a whole frame at or
+        // below the position
+        const auto base = Mixing::frames(static_cast<size_t>(std::max(first, 0L)));
+        const auto shift = Mixing::frames(static_cast<size_t>(std::max(-first, 0L)));
+        // Positions below this have all of their taps in the window
+        auto limit = Mixing::frames(static_cast<size_t>(first + static_cast<long>(length)) -
+                                    taps.after);
+        if (!is_looping()) {
+            limit = std::min(limit, Mixing::frames(loop_end));
+        }
+        const size_t count = std::min(std::max(frames_before(limit, rate), size_t{1}), frames);
+
+        _sampleIndex = kernel(outputBuffer, count, window, _sampleIndex - base + shift, rate,
+                              gain) +
+                       base - shift;
+        return count;
+    }
 
   private:
     const Sample* _sample = nullptr;
-    float _sampleIndex = 0;
+    typename Mixing::Position _sampleIndex = 0;
     float _frequency = 1.0f;
     float _volume = 1.0f;
+    float _panning = 0.5f;
     bool _is_active = false;
+    size_t _laps = 0;
+    VoiceSet* _voices = nullptr;
+    size_t _voice_index = 0;
 };
 
-extern std::ostream& operator<<(std::ostream& os, const Channel::Event::Action& action);
+using Channel = BasicChannel<FloatMixing>;
+using FixedPointChannel = BasicChannel<FixedPointMixing>;
+
+extern std::ostream& operator<<(std::ostream& os, const ChannelEvent::Action& action);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,50 @@
+#include "FixedPointMixing.h"
+
+template <typename Gain>
+static uint64_t render_nearest(int32_t* out, size_t frames, const int16_t* data,
+                               uint64_t position, uint64_t rate, Gain gain)
+{
+    for (; frames; --frames, out += Gain::channels) {
+        gain.add(out, data[position >> 32]);
+        position += rate;
+    }
+    return position;
+}
+
+template <typename Gain>
+static uint64_t render_linear(int32_t* out, size_t frames, const int16_t* data,
+                              uint64_t position, uint64_t rate, Gain gain)
+{
+    for (; frames; --frames, out += Gain::channels) {
+        const auto whole = static_cast<size_t>(position >> 32);
+        // The top 15 bits of the fraction: (s1 - s0) * t stays inside an int32
+        const auto t = static_cast<int32_t>(static_cast<uint32_t>(position) >> 17);
+        const int32_t s0 = data[whole];
+        const int32_t s1 = data[whole + 1];
+        gain.add(out, s0 + (((s1 - s0) * t) >> 15));
+        position += rate;
+    }
+    return position;
+}
+
+template <typename Gain>
+FixedVoiceKernel<Gain> FixedPointMixing::kernel(Interpolation interpolation)
+{
+    if (interpolation == Interpolation::nearest) {
+        return render_nearest<Gain>;
+    }
+    return render_linear<Gain>;
+}
+
+void FixedPointMixing::resolve(float* out, const Accumulator* accumulated, size_t samples)
+{
+    for (size_t i = 0; i < samples; ++i) {
+        auto v = accumulated[i];
+        v = v < -full_scale ? -full_scale : (v > full_scale - 1 ? full_scale - 1 : v);
+        out[i] = static_cast<float>(v) / static_cast<float>(full_scale);
+    }
+}
+
+template FixedVoiceKernel<FixedMonoGain> FixedPointMixing::kernel<FixedMonoGain>(Interpolation);
+template FixedVoiceKernel<FixedStereoGain>
+    FixedPointMixing::kernel<FixedStereoGain>(Interpolation);
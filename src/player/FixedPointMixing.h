@@ -0,0 +1,70 @@
+#ifndef _PLAYER_FIXED_POINT_MIXING_H_
+#define _PLAYER_FIXED_POINT_MIXING_H_
+
+#include "Interpolation.h"
+#include "Phase.h"
+#include "Sample.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// Gains for fixed point voices, 4096 being unity. Each frame adds (v * gain) >> 4 to the
+// accumulator, so a 16 bit frame at unity lands with 8 bits of headroom below it: full scale
+// is 1 << 23, and 256 full scale voices can be summed before an int32 overflows.
+struct FixedMonoGain {
+    static constexpr size_t channels = 1;
+    int32_t volume;
+    void add(int32_t* out, int32_t v) const { out[0] += (v * volume) >> 4; }
+};
+
+struct FixedStereoGain {
+    static constexpr size_t channels = 2;
+    int32_t left;
+    int32_t right;
+    void add(int32_t* out, int32_t v) const
+    {
+        out[0] += (v * left) >> 4;
+        out[1] += (v * right) >> 4;
+    }
+};
+
+template <typename Gain>
+using FixedVoiceKernel = uint64_t (*)(int32_t* out, size_t frames, const int16_t* data,
+                                      uint64_t position, uint64_t rate, Gain gain);
+
+// Integer only mixing: 16 bit frames, the 32.32 Phase, integer gains and int32 accumulation,
+// saturated to full scale once every voice is in. No floating point arithmetic touches a
+// voice's frames, so the output is bit identical on any compiler and CPU. Floats are only
+// converted on the way in (volumes, frequencies) and out (the saturated sum), both exactly
+// reproducible operations.
+//
+// Nearest and linear interpolation are supported. The table driven modes fall back to linear.
+struct FixedPointMixing : Phase {
+    using Frame = int16_t;
+    using Accumulator = int32_t;
+    using MonoGain = FixedMonoGain;
+    using StereoGain = FixedStereoGain;
+
+    static constexpr int32_t unity_gain = 4096;
+    static constexpr int32_t full_scale = 1 << 23;
+
+    static MonoGain mono_gain(float volume) { return {gain(volume)}; }
+    static StereoGain stereo_gain(float left, float right) { return {gain(left), gain(right)}; }
+
+    static const Frame* data(const Sample& sample) { return sample.pcm16(); }
+    template <typename Gain> static FixedVoiceKernel<Gain> kernel(Interpolation interpolation);
+
+    // Saturates `samples` accumulated samples to full scale and writes them out as floats
+    static void resolve(float* out, const Accumulator* accumulated, size_t samples);
+
+  private:
+    static int32_t gain(float volume)
+    {
+        // Capped at twice unity to keep a voice's contribution inside an int32
+        auto clamped = volume < 0 ? 0 : (volume > 2.0f ? 2.0f : volume);
+        return static_cast<int32_t>(std::lrint(clamped * static_cast<float>(unity_gain)));
+    }
+};
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef _PLAYER_FLOAT_MIXING_H_
+#define _PLAYER_FLOAT_MIXING_H_
+
+#include "Interpolation.h"
+#include "Phase.h"
+#include "Sample.h"
+#include "VoiceKernels.h"
+
+// Mixing policies tell BasicChannel and BasicMixer how a voice is stored, stepped and summed.
+// FloatMixing is the default: float frames, summed straight into the float output. Both step
+// through samples with the integer Phase.
+struct FloatMixing : Phase {
+    using Frame = float;
+    using Accumulator = float;
+    using MonoGain = ::MonoGain;
+    using StereoGain = ::StereoGain;
+
+    static MonoGain mono_gain(float volume) { return {volume}; }
+    static StereoGain stereo_gain(float left, float right) { return {left, right}; }
+
+    static const Frame* data(const Sample& sample) { return sample.data(); }
+    template <typename Gain> static VoiceKernel<Gain> kernel(Interpolation interpolation)
+    {
+        return voice_kernel<Gain>(interpolation);
+    }
+};
+
+#endif
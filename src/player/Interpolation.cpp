@@ -0,0 +1,113 @@
+#include "Interpolation.h"
+#include "Sample.h"
+
+#include <array>
+#include <cmath>
+
+template <size_t Taps> struct FilterTable {
+    std::array<float, interpolation_phases * Taps> weights;
+};
+
+static FilterTable<4> make_cubic_table()
+{
+    // Catmull-Rom flavoured cubic Hermite spline through frames -1, 0, 1 and 2
+    FilterTable<4> table;
+    for (size_t phase = 0; phase < interpolation_phases; ++phase) {
+        const double t = static_cast<double>(phase) / static_cast<double>(interpolation_phases);
+        const double t2 = t * t;
+        const double t3 = t2 * t;
+        float* w = &table.weights[phase * 4];
+        w[0] = static_cast<float>(-0.5 * t3 + t2 - 0.5 * t);
+        w[1] = static_cast<float>(1.5 * t3 - 2.5 * t2 + 1.0);
+        w[2] = static_cast<float>(-1.5 * t3 + 2.0 * t2 + 0.5 * t);
+        w[3] = static_cast<float>(0.5 * t3 - 0.5 * t2);
+    }
+    return table;
+}
+
+template <size_t Taps> static FilterTable<Taps> make_sinc_table()
+{
+    // Blackman windowed sinc, normalised so every phase has unity gain
+    const double pi = 3.14159265358979323846;
+    const double half_width = static_cast<double>(Taps / 2);
+    FilterTable<Taps> table;
+    for (size_t phase = 0; phase < interpolation_phases; ++phase) {
+        const double t = static_cast<double>(phase) / static_cast<double>(interpolation_phases);
+        float* w = &table.weights[phase * Taps];
+
+        double sum = 0;
+        for (size_t k = 0; k < Taps; ++k) {
+            const double x = static_cast<double>(k) - (half_width - 1) - t;
+            const double sinc = x == 0 ? 1.0 : std::sin(pi * x) / (pi * x);
+            const double window = 0.42 + 0.5 * std::cos(pi * x / half_width) +
+                                  0.08 * std::cos(2 * pi * x / half_width);
+            const double weight = sinc * window;
+            w[k] = static_cast<float>(weight);
+            sum += weight;
+        }
+        for (size_t k = 0; k < Taps; ++k) {
+            w[k] = static_cast<float>(static_cast<double>(w[k]) / sum);
+        }
+    }
+    return table;
+}
+
+static const FilterTable<4> cubic_table = make_cubic_table();
+static const FilterTable<8> sinc8_table = make_sinc_table<8>();
+static const FilterTable<16> sinc16_table = make_sinc_table<16>();
+
+static float frame_at(const Sample& sample, long index)
+{
+    if (index < 0) {
+        return 0;
+    }
+    auto frame = static_cast<size_t>(index);
+    if (frame >= sample.loopEnd()) {
+        if (sample.loopType() == Sample::LoopParams::Type::non_looping ||
+            sample.loopLength() == 0) {
+            return 0;
+        }
+        frame = sample.loopBegin() + (frame - sample.loopEnd()) % sample.loopLength();
+    }
+    return sample[frame];
+}
+
+const float* interpolation_table(Interpolation interpolation)
+{
+    switch (interpolation) {
+    case Interpolation::cubic:
+        return cubic_table.weights.data();
+    case Interpolation::sinc8:
+        return sinc8_table.weights.data();
+    case Interpolation::sinc16:
+        return sinc16_table.weights.data();
+    default:
+        return nullptr;
+    }
+}
+
+float interpolate(const Sample& sample, float position, Interpolation interpolation)
+{
+    switch (interpolation) {
+    case Interpolation::nearest:
+        return sample[static_cast<size_t>(position)];
+    case Interpolation::linear:
+        return sample[position];
+    default:
+        break;
+    }
+
+    const auto taps = interpolation_taps(interpolation);
+    const size_t tap_count = taps.before + taps.after + 1;
+    const auto whole = static_cast<size_t>(position);
+    const float t = position - static_cast<float>(whole);
+    const auto phase = static_cast<size_t>(t * static_cast<float>(interpolation_phases));
+    const float* weights = interpolation_table(interpolation) + phase * tap_count;
+
+    const long first = static_cast<long>(whole) - static_cast<long>(taps.before);
+    float sum = 0;
+    for (size_t k = 0; k < tap_count; ++k) {
+        sum += weights[k] * frame_at(sample, first + static_cast<long>(k));
+    }
+    return sum;
+}
@@ -0,0 +1,45 @@
+#ifndef _PLAYER_INTERPOLATION_H_
+#define _PLAYER_INTERPOLATION_H_
+
+#include <cstddef>
+
+class Sample;
+
+enum class Interpolation { nearest, linear, cubic, sinc8, sinc16 };
+
+// The frames an interpolator reads around a position p: floor(p) - before through
+// floor(p) + after.
+struct InterpolationTaps {
+    size_t before;
+    size_t after;
+};
+
+constexpr InterpolationTaps interpolation_taps(Interpolation interpolation)
+{
+    switch (interpolation) {
+    case Interpolation::nearest:
+        return {0, 0};
+    case Interpolation::linear:
+        return {0, 1};
+    case Interpolation::cubic:
+        return {1, 2};
+    case Interpolation::sinc8:
+        return {3, 4};
+    case Interpolation::sinc16:
+        return {7, 8};
+    }
+    return {0, 0};
+}
+
+// The cubic and sinc interpolators are table driven. Their tables hold, for each of
+// interpolation_phases fractional positions, the weights of the frames floor(p) - before
+// through floor(p) + after. They are built once, when the program starts.
+constexpr size_t interpolation_phases = 256;
+extern const float* interpolation_table(Interpolation interpolation);
+
+// Interpolates `sample` at `position`, treating frames before the start as silence and frames
+// past the loop end as the start of the loop (or silence for one shot samples). This is the
+// reference the renderer's edge handling matches.
+extern float interpolate(const Sample& sample, float position, Interpolation interpolation);
+
+#endif
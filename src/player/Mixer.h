@@ -1,33 +1,51 @@
 #ifndef _MIXER_H_
 #define _MIXER_H_
 
-#include <list>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
 #include <vector>
 
 #include "Channel.h"
+#include "Tracer.h"
+#include "WorkerPool.h"
 
-class Mixer {
+struct MixerEvent {
+    size_t channel;
+    ChannelEvent::Action action;
+    bool operator==(const MixerEvent& rhs) const
+    {
+        return channel == rhs.channel && action == rhs.action;
+    }
+};
+
+// Mixes a set of BasicChannels with the same Mixing policy. Mixer, the float pipeline, is what
+// the player uses unless it is built with IMPULSE_FIXED_POINT.
+template <typename Mixing> class BasicMixer {
 
   public:
-    struct Event {
-        size_t channel;
-        Channel::Event::Action action;
-        bool operator==(const Event& rhs) const
-        {
-            return channel == rhs.channel && action == rhs.action;
-        }
-    };
+    using Event = MixerEvent;
+    using Channel = BasicChannel<Mixing>;
+    using Accumulator = typename Mixing::Accumulator;
 
     struct TickHandler {
-        virtual void onAttachment(Mixer& audio) = 0;
-        virtual void onTick(Mixer& audio) = 0;
+        virtual void onAttachment(BasicMixer& audio) = 0;
+        virtual void onTick(BasicMixer& audio) = 0;
         virtual ~TickHandler() = default;
     };
 
-    Mixer(const unsigned int sample_rate_ = 1, const size_t channel_count = 1)
-        : _sample_rate(sample_rate_), _auxilliary_buffer(1024), _channels(channel_count)
+    BasicMixer(const unsigned int sample_rate_ = 1, const size_t channel_count = 1)
+        : _sample_rate(sample_rate_), _active_voices(channel_count), _channels(channel_count)
     {
+        for (size_t c = 0; c < _channels.size(); ++c) {
+            _channels[c].attach(&_active_voices, c);
+        }
+        reserve_scratch();
     }
+    // Channels hold on to _active_voices, so a Mixer stays where it was built
+    BasicMixer(const BasicMixer&) = delete;
+    BasicMixer& operator=(const BasicMixer&) = delete;
 
     void process_event(const Event& event) { channel(event.channel).process_event(event.action); }
 
@@ -39,46 +57,248 @@ class Mixer {
 
     void render(float* outputBuffer, size_t samplesToFill)
     {
-        memset(outputBuffer, 0, samplesToFill * sizeof(float));
-        while (samplesToFill) {
+        render_frames<typename Mixing::MonoGain>(outputBuffer, samplesToFill,
+                                                 [] { return false; });
+    }
+
+    // Renders interleaved left/right frames, each voice placed by its channel's panning
+    void render_stereo(float* outputBuffer, size_t framesToFill)
+    {
+        render_frames<typename Mixing::StereoGain>(outputBuffer, framesToFill,
+                                                   [] { return false; });
+    }
+    // Renders as render_stereo does, but stops short of the first tick for which `stop()` is
+    // true. Returns the frames rendered.
+    template <typename Stop>
+    size_t render_stereo_until(float* outputBuffer, size_t framesToFill, Stop&& stop)
+    {
+        return render_frames<typename Mixing::StereoGain>(outputBuffer, framesToFill, stop);
+    }
+
+    // Moves playback on by `frames` frames as a render would, ticks and all, without mixing
+    // anything
+    void skip(size_t frames)
+    {
+        while (frames) {
             if (_samples_until_next_tick == 0) {
                 for (auto handler : _handlers) {
                     handler->onTick(*this);
                 }
                 _samples_until_next_tick = _samples_per_tick;
             }
+            const size_t skipped = std::min(_samples_until_next_tick, frames);
+            frames -= skipped;
+            _samples_until_next_tick -= skipped;
+            _active_voices.for_each(
+                [&](size_t c) { _channels[c].advance(skipped, _sample_rate); });
+        }
+    }
 
-            auto samples_to_render = std::min(_samples_until_next_tick, samplesToFill);
+    // Everything one render carries over to the next: every voice's sample, position, pitch,
+    // volume and panning, and where the next tick falls
+    struct State {
+        std::vector<Channel> channels;
+        size_t samples_per_tick = 1;
+        size_t samples_until_next_tick = 0;
+    };
+    void save(State& state) const
+    {
+        state.channels = _channels;
+        state.samples_per_tick = _samples_per_tick;
+        state.samples_until_next_tick = _samples_until_next_tick;
+    }
+    // Carries on from a State saved by a mixer with as many channels. Restoring into a mixer
+    // that already has that many allocates nothing.
+    void restore(const State& state)
+    {
+        for (size_t c = 0; c < _channels.size() && c < state.channels.size(); ++c) {
+            _channels[c] = state.channels[c];
+            _channels[c].attach(&_active_voices, c);
+        }
+        _samples_per_tick = state.samples_per_tick;
+        _samples_until_next_tick = state.samples_until_next_tick;
+    }
 
-            samplesToFill -= samples_to_render;
-            _samples_until_next_tick -= samples_to_render;
-            for (auto& channel : _channels) {
-                channel.render(&_auxilliary_buffer[0], samples_to_render, _sample_rate);
-                for (size_t i = 0; i < samples_to_render; ++i) {
-                    outputBuffer[i] += _auxilliary_buffer[i];
-                }
-            }
-            outputBuffer += samples_to_render;
+    // Spreads voice mixing over `thread_count` threads, the calling one included. Zero (the
+    // default) mixes every voice straight into the output on the calling thread, which is what
+    // the real-time callback wants: it takes no locks.
+    //
+    // Worker mixing gives each slice of voices_per_slice channels its own partial buffer and
+    // sums the partials in slice order, so its output is identical for any thread count. It
+    // adds voices in a different order from inline mixing, so the two may differ in the last
+    // bits.
+    void set_thread_count(size_t thread_count)
+    {
+        _workers.reset();
+        if (thread_count) {
+            _workers = std::make_unique<WorkerPool>(thread_count);
+            _busy_slices.reserve(slice_count());
         }
+        reserve_scratch();
+    }
+    size_t thread_count() const { return _workers ? _workers->thread_count() : 0; }
+
+    static constexpr size_t voices_per_slice = 8;
+
+    // Renders of any length are mixed in blocks of at most this many frames, so every voice in
+    // a block mixes into output that is still in cache, and the worker partials and fixed point
+    // accumulator never grow past one block however long a render or a tick is.
+    void set_block_frames(size_t frames)
+    {
+        _block_frames = std::max(frames, size_t{1});
+        reserve_scratch();
     }
+    size_t block_frames() const { return _block_frames; }
+    static constexpr size_t default_block_frames = 1024;
+
+    // Trades quality against CPU time for every voice. Linear is the default.
+    void set_interpolation(Interpolation interpolation) { _interpolation = interpolation; }
+    Interpolation interpolation() const { return _interpolation; }
 
     Channel& channel(size_t c) { return _channels[c]; }
     const Channel& channel(size_t c) const { return _channels[c]; }
 
     void set_samples_per_tick(size_t spt) { _samples_per_tick = spt; }
     size_t samples_per_tick() const { return _samples_per_tick; }
+    // Zero when the next render starts with a tick
+    size_t samples_until_next_tick() const { return _samples_until_next_tick; }
     unsigned int sampling_rate() const { return _sample_rate; }
+    size_t active_voice_count() const { return _active_voices.size(); }
+
+  private:
+    // Scratch buffers are sized for a stereo block whenever the block length or thread count
+    // changes, so rendering itself never allocates
+    void reserve_scratch()
+    {
+        const size_t samples = _block_frames * Mixing::StereoGain::channels;
+        if constexpr (!std::is_same_v<Accumulator, float>) {
+            _accumulator.resize(samples);
+        }
+        if (_workers) {
+            _partials.resize(slice_count() * partial_stride(samples) + 16);
+        }
+    }
+
+    size_t slice_count() const
+    {
+        return (_channels.size() + voices_per_slice - 1) / voices_per_slice;
+    }
+    // Keeps each partial on its own cache lines
+    static size_t partial_stride(size_t samples) { return (samples + 15) & ~size_t{15}; }
+
+    template <typename Gain, typename Stop>
+    size_t render_frames(float* outputBuffer, size_t samplesToFill, Stop&& stop)
+    {
+        TraceSpan span("Mixer::render", "frames", static_cast<int64_t>(samplesToFill));
+        memset(outputBuffer, 0, samplesToFill * Gain::channels * sizeof(float));
+        const size_t requested = samplesToFill;
+        while (samplesToFill) {
+            if (_samples_until_next_tick == 0) {
+                if (stop()) {
+                    break;
+                }
+                for (auto handler : _handlers) {
+                    handler->onTick(*this);
+                }
+                _samples_until_next_tick = _samples_per_tick;
+            }
+
+            auto samples_to_render =
+                std::min({_samples_until_next_tick, samplesToFill, _block_frames});
+
+            samplesToFill -= samples_to_render;
+            _samples_until_next_tick -= samples_to_render;
+            if constexpr (std::is_same_v<Accumulator, float>) {
+                mix_frames<Gain>(outputBuffer, samples_to_render);
+            } else {
+                // Integer voices sum into the accumulator, which only becomes float output
+                // once every voice is in
+                const size_t samples = samples_to_render * Gain::channels;
+                std::fill_n(_accumulator.begin(), samples, Accumulator{0});
+                mix_frames<Gain>(_accumulator.data(), samples_to_render);
+                Mixing::resolve(outputBuffer, _accumulator.data(), samples);
+            }
+            outputBuffer += samples_to_render * Gain::channels;
+        }
+        return requested - samplesToFill;
+    }
+
+    template <typename Gain> void mix_frames(Accumulator* outputBuffer, size_t frames)
+    {
+        if (_workers) {
+            mix_on_workers<Gain>(outputBuffer, frames);
+        } else {
+            _active_voices.for_each([&](size_t c) { mix_voice<Gain>(c, outputBuffer, frames); });
+        }
+    }
+
+    template <typename Gain> void mix_voice(size_t c, Accumulator* outputBuffer, size_t frames)
+    {
+        TraceSpan span("voice", "channel", static_cast<int64_t>(c));
+        auto& channel = _channels[c];
+        if constexpr (Gain::channels == 2) {
+            channel.mix_stereo(outputBuffer, frames, _sample_rate, _interpolation);
+        } else {
+            channel.mix(outputBuffer, frames, _sample_rate, _interpolation);
+        }
+    }
+
+    template <typename Gain> void mix_on_workers(Accumulator* outputBuffer, size_t frames)
+    {
+        const size_t samples = frames * Gain::channels;
+        const size_t stride = partial_stride(samples);
+        auto address = reinterpret_cast<uintptr_t>(_partials.data());
+        Accumulator* partials =
+            _partials.data() + ((64 - address % 64) % 64) / sizeof(Accumulator);
+
+        _busy_slices.clear();
+        _active_voices.for_each([&](size_t c) {
+            if (_busy_slices.empty() || _busy_slices.back() != c / voices_per_slice) {
+                _busy_slices.push_back(c / voices_per_slice);
+            }
+        });
+
+        auto mix_slice = [&](size_t i) {
+            const size_t slice = _busy_slices[i];
+            Accumulator* partial = partials + slice * stride;
+            std::fill_n(partial, samples, Accumulator{0});
+            const size_t end = std::min(_channels.size(), (slice + 1) * voices_per_slice);
+            for (size_t c = slice * voices_per_slice; c < end; ++c) {
+                if (_active_voices.contains(c)) {
+                    mix_voice<Gain>(c, partial, frames);
+                }
+            }
+        };
+        _workers->run(_busy_slices.size(), mix_slice);
+
+        for (auto slice : _busy_slices) {
+            const Accumulator* partial = partials + slice * stride;
+            for (size_t i = 0; i < samples; ++i) {
+                outputBuffer[i] += partial[i];
+            }
+        }
+    }
 
   private:
     size_t _samples_until_next_tick = 0;
     size_t _samples_per_tick = 1;
+    size_t _block_frames = default_block_frames;
     unsigned int _sample_rate = 1;
-    std::vector<float> _auxilliary_buffer;
+    Interpolation _interpolation = Interpolation::linear;
 
-    std::list<TickHandler*> _handlers;
+    std::vector<TickHandler*> _handlers;
+    VoiceSet _active_voices;
     std::vector<Channel> _channels;
+
+    std::unique_ptr<WorkerPool> _workers;
+    std::vector<size_t> _busy_slices;
+    std::vector<Accumulator> _partials;
+    std::vector<Accumulator> _accumulator;
 };
 
-extern std::ostream& operator<<(std::ostream& os, const Mixer::Event& event);
+using Mixer = BasicMixer<FloatMixing>;
+using FixedPointMixer = BasicMixer<FixedPointMixing>;
+
+extern std::ostream& operator<<(std::ostream& os, const MixerEvent& event);
 
 #endif
\ No newline at end of file
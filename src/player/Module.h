@@ -4,6 +4,7 @@
 #include <player/Pattern.h>
 #include <player/Sample.h>
 
+#include <algorithm>
 #include <cinttypes>
 #include <vector>
 
@@ -22,8 +23,33 @@ struct Module {
     std::vector<Sample> samples;
     std::vector<Pattern> patterns;
     std::vector<uint8_t> patternOrder;
+    // Initial pan of each channel, from 0 (left) to 64 (right). Channels past the end of the
+    // list start centred.
+    std::vector<uint8_t> channel_panning;
     int initial_speed;
     int initial_tempo;
+
+    // The channels a Player of the module plays: as many as its widest pattern has
+    size_t channel_count() const
+    {
+        size_t count = 0;
+        for (const auto& pattern : patterns) {
+            count = std::max(count, pattern.channel_count());
+        }
+        return count;
+    }
+    // Narrows every pattern to the highest channel any of them uses, for loaders that decode
+    // into patterns as wide as their format can address
+    void fit_channels()
+    {
+        size_t used = 1;
+        for (const auto& pattern : patterns) {
+            used = std::max(used, pattern.used_channel_count());
+        }
+        for (auto& pattern : patterns) {
+            pattern.set_channel_count(used);
+        }
+    }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,29 @@
+#include "ModuleRenderer.h"
+#include "Module.h"
+
+static std::unique_ptr<ModuleRenderer> renderer_for(const std::shared_ptr<Module>& module,
+                                                    bool stop_at_song_end)
+{
+    if (!module || !is_playable(*module)) {
+        return nullptr;
+    }
+    return std::make_unique<ModuleRenderer>(module, stop_at_song_end);
+}
+
+std::unique_ptr<ModuleRenderer> ModuleRenderer::from_file(const std::string& path,
+                                                          bool stop_at_song_end)
+{
+    return renderer_for(load_module(path), stop_at_song_end);
+}
+
+std::unique_ptr<ModuleRenderer> ModuleRenderer::from_memory(const void* data, size_t size,
+                                                            ModuleFormat format,
+                                                            bool stop_at_song_end)
+{
+    return renderer_for(load_module(data, size, format), stop_at_song_end);
+}
+
+ModuleRenderer::ModuleRenderer(const std::shared_ptr<Module>& module, bool stop_at_song_end)
+    : _player(module), _renderer(_player, stop_at_song_end)
+{
+}
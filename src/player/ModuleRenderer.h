@@ -0,0 +1,47 @@
+#ifndef _PLAYER_MODULE_RENDERER_H_
+#define _PLAYER_MODULE_RENDERER_H_
+
+#include "OfflineRenderer.h"
+#include "Player.h"
+
+#include <loader/module.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+struct Module;
+
+// The engine's embedding API: load a module, then pull audio from it into your own buffers at
+// whatever pace your I/O loop runs. Audio is always interleaved stereo float at
+// sample_rate(), and the mixer writes it straight into the buffer given, with no copy in
+// between. Nothing here touches an audio device.
+class ModuleRenderer {
+  public:
+    static constexpr size_t channels = 2;
+
+    // Return nullptr when the module can't be loaded, or has nothing to play
+    static std::unique_ptr<ModuleRenderer> from_file(const std::string& path,
+                                                     bool stop_at_song_end = true);
+    static std::unique_ptr<ModuleRenderer> from_memory(const void* data, size_t size,
+                                                       ModuleFormat format,
+                                                       bool stop_at_song_end = true);
+
+    explicit ModuleRenderer(const std::shared_ptr<Module>& module, bool stop_at_song_end = true);
+
+    // Renders up to `frames` frames into `out`, which holds channels floats per frame. Returns
+    // how many it rendered, fewer than asked for only once the song has ended.
+    size_t render(float* out, size_t frames) { return _renderer.render(out, frames); }
+
+    bool finished() const { return _renderer.song_ended(); }
+    unsigned int sample_rate() const { return _player.mixer().sampling_rate(); }
+
+    // For seeking, muting and the like, through Player::send()
+    Player& player() { return _player; }
+
+  private:
+    Player _player;
+    OfflineRenderer _renderer;
+};
+
+#endif
@@ -0,0 +1,65 @@
+#include "OfflineRenderer.h"
+#include "Player.h"
+#include "WavWriter.h"
+
+#include <algorithm>
+#include <vector>
+
+OfflineRenderer::OfflineRenderer(Player& player, bool stop_at_song_end)
+    : _player(player),
+      _stop_at_song_end(stop_at_song_end),
+      _slots(*player.module),
+      _played(_slots.size())
+{
+}
+
+size_t OfflineRenderer::render(float* out, size_t frames)
+{
+    if (!_stop_at_song_end) {
+        _player.render_stereo_audio(out, static_cast<int>(frames));
+        return frames;
+    }
+
+    // Whole blocks, cut short only at the tick that would play a row over again
+    const size_t rendered = _player.render_stereo_until(
+        out, frames,
+        [](void* renderer) {
+            return static_cast<OfflineRenderer*>(renderer)->song_ends_at_next_tick();
+        },
+        this);
+    _song_ended = rendered < frames;
+    return rendered;
+}
+
+bool OfflineRenderer::song_ends_at_next_tick()
+{
+    if (_player.tick_counter != 1) {
+        return false;
+    }
+    // Where playback goes next depends only on the row it is on, so a row coming round again
+    // repeats everything since. A break to a row past the end of the pattern ends the song too.
+    const auto slot = _slots.slot(_player.current_order, _player.current_row);
+    if (!slot || _played[*slot]) {
+        return true;
+    }
+    _played[*slot] = true;
+    return false;
+}
+
+size_t render_to_wav(Player& player, std::ostream& os, double seconds)
+{
+    const unsigned int sample_rate = player.mixer().sampling_rate();
+    WavWriter wav(os, sample_rate, 2);
+    OfflineRenderer renderer(player, seconds <= 0);
+    const auto frame_limit = static_cast<size_t>((seconds > 0 ? seconds : 3600.0) * sample_rate);
+    std::vector<float> block(2 * OfflineRenderer::block_frames);
+
+    while (wav.frames_written() < frame_limit && !renderer.song_ended()) {
+        const size_t frames = renderer.render(
+            block.data(),
+            std::min(OfflineRenderer::block_frames, frame_limit - wav.frames_written()));
+        wav.write(block.data(), frames);
+    }
+    wav.finish();
+    return wav.frames_written();
+}
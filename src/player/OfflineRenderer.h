@@ -0,0 +1,45 @@
+#ifndef _PLAYER_OFFLINE_RENDERER_H_
+#define _PLAYER_OFFLINE_RENDERER_H_
+
+#include "RowSlots.h"
+
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+struct Player;
+
+// Drives a Player as fast as the CPU allows, for rendering to a file rather than a device.
+// Playback can stop where the song ends instead of looping forever: ahead of the first row to
+// come round a second time, whether the order list wraps back to the start or a jump goes back
+// to a row already played, just where SongTimeline finds the song's end.
+class OfflineRenderer {
+  public:
+    // A good number of frames to ask for at a time
+    static constexpr size_t block_frames = 65536;
+
+    explicit OfflineRenderer(Player& player, bool stop_at_song_end = true);
+
+    // Renders up to `frames` interleaved stereo frames into `out`, fewer once the song has
+    // ended. Returns how many it rendered.
+    size_t render(float* out, size_t frames);
+
+    bool song_ended() const { return _song_ended; }
+
+  private:
+    // Marks the row the next tick starts as played. True should it have played already.
+    bool song_ends_at_next_tick();
+
+    Player& _player;
+    bool _stop_at_song_end;
+    bool _song_ended = false;
+    RowSlots _slots;
+    // By slot, whether the row has played
+    std::vector<bool> _played;
+};
+
+// Renders `player` to `os` as a stereo WAV file, for `seconds` or, given none, to the end of
+// the song. Songs that never end stop after an hour. Returns the frames written.
+extern size_t render_to_wav(Player& player, std::ostream& os, double seconds = 0);
+
+#endif
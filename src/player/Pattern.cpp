@@ -1,12 +1,41 @@
 #include "Pattern.h"
 
+size_t Pattern::used_channel_count() const
+{
+    size_t used = 0;
+    for (size_t r = 0; r < _row_count; ++r) {
+        for (size_t c = _channel_count; c > used; --c) {
+            if (!entry(r, c - 1).is_empty()) {
+                used = c;
+                break;
+            }
+        }
+    }
+    return used;
+}
+
+void Pattern::set_channel_count(size_t channel_count)
+{
+    channel_count = std::min(channel_count, max_channels);
+    if (channel_count == _channel_count) {
+        return;
+    }
+    std::vector<Entry> entries(_row_count * channel_count);
+    const size_t kept = std::min(channel_count, _channel_count);
+    for (size_t r = 0; r < _row_count; ++r) {
+        std::copy(row(r), row(r) + kept, entries.data() + r * channel_count);
+    }
+    _entries = std::move(entries);
+    _channel_count = channel_count;
+}
+
 bool parse_pattern(std::string::const_iterator& start, const std::string::const_iterator& last,
                    Pattern& pattern)
 {
     size_t current_row = 0;
     size_t current_channel = 0;
     while (start != last && current_row < pattern.row_count()) {
-        pattern.channel(current_channel++).row(current_row) = parse_pattern_entry(start, last);
+        pattern.entry(current_row, current_channel++) = parse_pattern_entry(start, last);
         // Look for a newline to advance to next row
         while (std::isspace(*start)) {
             if (*start++ == '\n') {
@@ -29,10 +58,10 @@ bool parse_pattern(const std::string& text, Pattern& pattern)
     return parse_pattern(start, text.end(), pattern);
 }
 
-std::ostream& operator<<(std::ostream& os, const Pattern::Channel& channel)
+std::ostream& operator<<(std::ostream& os, const Pattern::ConstChannel& channel)
 {
-    for (const auto entry : channel.rows()) {
-        os << entry << "\n";
+    for (size_t r = 0; r < channel.row_count(); ++r) {
+        os << channel.row(r) << "\n";
     }
     return os;
 }
@@ -3,47 +3,87 @@
 
 #include <player/PatternEntry.h>
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <vector>
 
+// Every entry of the pattern in one allocation, a row at a time: a row's entries for every
+// channel sit side by side, in the order the player reads them each tick.
 class Pattern {
   public:
     using Entry = PatternEntry;
-    class Channel {
-      public:
-        Channel(size_t row_count) : _rows(row_count) {}
-
-        Entry& row(size_t r) { return _rows[r]; }
-        const Entry& row(size_t r) const { return _rows[r]; }
+    // Patterns are as wide as a module needs, up to the 64 channels IT addresses
+    static constexpr size_t default_channels = 32;
+    static constexpr size_t max_channels = 64;
 
-        const std::vector<Entry>& rows() const { return _rows; }
+    // One channel's entries down the pattern, a row's width apart
+    template <typename E> class ChannelView {
+      public:
+        ChannelView(E* first, size_t row_count, size_t stride)
+            : _first(first), _row_count(row_count), _stride(stride)
+        {
+        }
+        template <typename Other>
+        ChannelView(const ChannelView<Other>& other)
+            : _first(other._first), _row_count(other._row_count), _stride(other._stride)
+        {
+        }
 
-        bool operator==(const Channel& rhs) const { return _rows == rhs._rows; }
+        E& row(size_t r) const { return _first[r * _stride]; }
+        size_t row_count() const { return _row_count; }
 
       private:
-        std::vector<Entry> _rows;
+        template <typename> friend class ChannelView;
+
+        E* _first;
+        size_t _row_count;
+        size_t _stride;
     };
+    using Channel = ChannelView<Entry>;
+    using ConstChannel = ChannelView<const Entry>;
 
   public:
-    Pattern(size_t row_count) : _channels(32, Channel(row_count)), _row_count(row_count) {}
+    Pattern(size_t row_count, size_t channel_count = default_channels)
+        : _entries(row_count * std::min(channel_count, max_channels)), _row_count(row_count),
+          _channel_count(std::min(channel_count, max_channels))
+    {
+    }
+
+    bool operator==(const Pattern& rhs) const
+    {
+        return _channel_count == rhs._channel_count && _entries == rhs._entries;
+    }
 
-    bool operator==(const Pattern& rhs) const { return _channels == rhs._channels; }
+    // The channel_count() entries of row `r`
+    Entry* row(size_t r) { return _entries.data() + r * _channel_count; }
+    const Entry* row(size_t r) const { return _entries.data() + r * _channel_count; }
+    Entry& entry(size_t r, size_t c) { return _entries[r * _channel_count + c]; }
+    const Entry& entry(size_t r, size_t c) const { return _entries[r * _channel_count + c]; }
 
-    Channel& channel(size_t c) { return _channels[c]; }
-    const Channel& channel(size_t c) const { return _channels[c]; }
+    Channel channel(size_t c) { return {_entries.data() + c, _row_count, _channel_count}; }
+    ConstChannel channel(size_t c) const
+    {
+        return {_entries.data() + c, _row_count, _channel_count};
+    }
     size_t row_count() const { return _row_count; }
-    size_t channel_count() const { return _channels.size(); }
+    size_t channel_count() const { return _channel_count; }
+
+    // One past the highest channel with anything in it, 0 for an empty pattern
+    size_t used_channel_count() const;
+    // Keeps the first `channel_count` channels of every row, adding empty ones as needed
+    void set_channel_count(size_t channel_count);
 
   private:
-    std::vector<Channel> _channels;
+    std::vector<Entry> _entries;
     size_t _row_count;
+    size_t _channel_count;
 };
 
 extern bool parse_pattern(std::string::const_iterator& start,
                           const std::string::const_iterator& last, Pattern& pattern);
 extern bool parse_pattern(const std::string& text, Pattern& pattern);
-extern std::ostream& operator<<(std::ostream& os, const Pattern::Channel& channel);
+extern std::ostream& operator<<(std::ostream& os, const Pattern::ConstChannel& channel);
 extern std::ostream& operator<<(std::ostream& os, const Pattern& pattern);
 
 #endif
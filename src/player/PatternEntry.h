@@ -115,6 +115,13 @@ struct PatternEntry {
     {
     }
 
+    // Nothing the player acts on: the parameters of effects without a command are ignored
+    bool is_empty() const
+    {
+        return note.is_empty() && !inst && volume_effect.comm == Command::none &&
+               effect.comm == Command::none;
+    }
+
     bool operator==(const PatternEntry& rhs) const
     {
         return note == rhs.note && inst == rhs.inst && volume_effect == rhs.volume_effect &&
@@ -127,6 +134,9 @@ struct PatternEntry {
     Effect effect;
 };
 
+// Patterns hold a module's worth of these, a row of them read every tick
+static_assert(sizeof(PatternEntry) == 6, "PatternEntry should pack into 6 bytes");
+
 extern std::ostream& operator<<(std::ostream& os, const PatternEntry::Note& note);
 extern std::ostream& operator<<(std::ostream& os, const PatternEntry& pe);
 extern PatternEntry parse_pattern_entry(const std::string& text);
@@ -0,0 +1,38 @@
+#include "PatternEvents.h"
+
+PatternEvents::PatternEvents(const Pattern& pattern)
+{
+    _row_starts.reserve(pattern.row_count() + 1);
+    _row_channels.reserve(pattern.row_count());
+    _global_rows.reserve(pattern.row_count());
+    for (size_t r = 0; r < pattern.row_count(); ++r) {
+        _row_starts.push_back(static_cast<uint32_t>(_cells.size()));
+        uint64_t channels = 0;
+        bool global = false;
+        const auto* row = pattern.row(r);
+        for (size_t c = 0; c < pattern.channel_count(); ++c) {
+            if (row[c].is_empty()) {
+                continue;
+            }
+            _cells.push_back({static_cast<uint8_t>(c), row[c]});
+            channels |= uint64_t{1} << c;
+            global = global || is_global_command(row[c].effect);
+        }
+        _row_channels.push_back(channels);
+        _global_rows.push_back(global);
+    }
+    _row_starts.push_back(static_cast<uint32_t>(_cells.size()));
+}
+
+bool PatternEvents::is_global_command(const PatternEntry::Effect& effect)
+{
+    switch (effect.comm) {
+    case PatternEntry::Command::set_speed:
+    case PatternEntry::Command::jump_to_order:
+    case PatternEntry::Command::break_to_row:
+    case PatternEntry::Command::set_tempo:
+        return true;
+    default:
+        return false;
+    }
+}
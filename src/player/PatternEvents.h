@@ -0,0 +1,53 @@
+#ifndef _PLAYER_PATTERN_EVENTS_H_
+#define _PLAYER_PATTERN_EVENTS_H_
+
+#include <player/Pattern.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A Pattern compiled down to what the player acts on: each row's non-empty entries only, with
+// the channels they fall on, so starting a row costs time in proportion to what is in it.
+class PatternEvents {
+    static_assert(Pattern::max_channels <= 64, "A row's channels must fit a 64 bit mask");
+
+  public:
+    explicit PatternEvents(const Pattern& pattern);
+
+    struct Cell {
+        uint8_t channel;
+        PatternEntry entry;
+    };
+    struct Row {
+        const Cell* begin() const { return first; }
+        const Cell* end() const { return last; }
+
+        const Cell* first;
+        const Cell* last;
+        // Bit c set for a cell on channel c
+        uint64_t channels;
+        // Whether any cell changes the speed, tempo or position in the song
+        bool has_global_commands;
+    };
+
+    // Cells in channel order
+    Row row(size_t r) const
+    {
+        const Cell* cells = _cells.data();
+        return {cells + _row_starts[r], cells + _row_starts[r + 1], _row_channels[r],
+                _global_rows[r] != 0};
+    }
+    size_t row_count() const { return _row_channels.size(); }
+
+    static bool is_global_command(const PatternEntry::Effect& effect);
+
+  private:
+    std::vector<Cell> _cells;
+    // Row r's cells run from _row_starts[r] to _row_starts[r + 1]
+    std::vector<uint32_t> _row_starts;
+    std::vector<uint64_t> _row_channels;
+    std::vector<uint8_t> _global_rows;
+};
+
+#endif
@@ -0,0 +1,111 @@
+#include "PerfCounters.h"
+
+// Only the recording thread stores, so a load and a store make a max without a CAS loop
+template <typename T> static void store_max(std::atomic<T>& max, T value)
+{
+    if (value > max.load(std::memory_order_relaxed)) {
+        max.store(value, std::memory_order_relaxed);
+    }
+}
+
+size_t PerfCounters::histogram_bucket(std::chrono::nanoseconds duration)
+{
+    size_t bucket = 0;
+    for (std::chrono::nanoseconds limit = first_bucket_limit;
+         bucket + 1 < histogram_buckets && duration >= limit; limit *= 2) {
+        ++bucket;
+    }
+    return bucket;
+}
+
+void PerfCounters::record_callback(std::chrono::nanoseconds took,
+                                   std::chrono::nanoseconds deadline)
+{
+    _callbacks.fetch_add(1, std::memory_order_relaxed);
+    if (took > deadline) {
+        _deadline_misses.fetch_add(1, std::memory_order_relaxed);
+    }
+    _callback_ns.fetch_add(took.count(), std::memory_order_relaxed);
+    store_max(_max_callback_ns, static_cast<int64_t>(took.count()));
+    _deadline_ns.store(deadline.count(), std::memory_order_relaxed);
+    _histogram[histogram_bucket(took)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void PerfCounters::record_render(std::chrono::nanoseconds took, size_t frames)
+{
+    _renders.fetch_add(1, std::memory_order_relaxed);
+    _rendered_frames.fetch_add(frames, std::memory_order_relaxed);
+    _render_ns.fetch_add(took.count(), std::memory_order_relaxed);
+}
+
+void PerfCounters::record_tick(std::chrono::nanoseconds took, size_t events,
+                               size_t active_voices)
+{
+    _ticks.fetch_add(1, std::memory_order_relaxed);
+    _tick_ns.fetch_add(took.count(), std::memory_order_relaxed);
+    store_max(_max_tick_ns, static_cast<int64_t>(took.count()));
+    _events.fetch_add(events, std::memory_order_relaxed);
+    _active_voices.store(active_voices, std::memory_order_relaxed);
+    store_max(_max_active_voices, static_cast<uint64_t>(active_voices));
+}
+
+PerfCounters::Snapshot PerfCounters::snapshot() const
+{
+    const auto relaxed = std::memory_order_relaxed;
+    Snapshot s;
+    s.callbacks = _callbacks.load(relaxed);
+    s.deadline_misses = _deadline_misses.load(relaxed);
+    s.underflows = _underflows.load(relaxed);
+    s.overflows = _overflows.load(relaxed);
+    s.callback_ns = _callback_ns.load(relaxed);
+    s.max_callback_ns = _max_callback_ns.load(relaxed);
+    s.deadline_ns = _deadline_ns.load(relaxed);
+    for (size_t b = 0; b < histogram_buckets; ++b) {
+        s.histogram[b] = _histogram[b].load(relaxed);
+    }
+    s.renders = _renders.load(relaxed);
+    s.rendered_frames = _rendered_frames.load(relaxed);
+    s.render_ns = _render_ns.load(relaxed);
+    s.ticks = _ticks.load(relaxed);
+    s.tick_ns = _tick_ns.load(relaxed);
+    s.max_tick_ns = _max_tick_ns.load(relaxed);
+    s.events = _events.load(relaxed);
+    s.active_voices = _active_voices.load(relaxed);
+    s.max_active_voices = _max_active_voices.load(relaxed);
+    return s;
+}
+
+static double per(double total, uint64_t count)
+{
+    return count ? total / static_cast<double>(count) : 0.0;
+}
+
+std::ostream& operator<<(std::ostream& os, const PerfCounters::Snapshot& s)
+{
+    os << "callbacks: " << s.callbacks << ", " << s.deadline_misses << " over deadline, "
+       << s.underflows << " underflows, " << s.overflows << " overflows\n";
+    os << "callback: " << per(static_cast<double>(s.callback_ns) / 1000, s.callbacks)
+       << " us mean, " << s.max_callback_ns / 1000 << " us max, " << s.deadline_ns / 1000
+       << " us deadline\n";
+
+    // Ticks run inside renders, so what's left of the render time went on mixing voices
+    const auto mix_ns = s.render_ns - s.tick_ns;
+    os << "render: " << per(static_cast<double>(s.render_ns), s.rendered_frames)
+       << " ns per frame, " << s.tick_ns / 1000000 << " ms in ticks, " << mix_ns / 1000000
+       << " ms mixing\n";
+    os << "ticks: " << s.ticks << ", " << per(static_cast<double>(s.tick_ns) / 1000, s.ticks)
+       << " us mean, " << s.max_tick_ns / 1000 << " us max, "
+       << per(static_cast<double>(s.events), s.ticks) << " events each\n";
+    os << "voices: " << s.active_voices << " active, " << s.max_active_voices << " at most\n";
+
+    os << "callback durations:";
+    auto limit = PerfCounters::first_bucket_limit;
+    for (size_t b = 0; b < PerfCounters::histogram_buckets; ++b, limit *= 2) {
+        if (b + 1 < PerfCounters::histogram_buckets) {
+            os << " <" << limit.count() << "us:" << s.histogram[b];
+        } else {
+            os << " more:" << s.histogram[b];
+        }
+    }
+    return os << "\n";
+}
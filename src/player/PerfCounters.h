@@ -0,0 +1,87 @@
+#ifndef _PLAYER_PERF_COUNTERS_H_
+#define _PLAYER_PERF_COUNTERS_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+// Counters the audio path updates as it plays, for a monitoring thread to read at any time.
+// Recording is a handful of relaxed atomic updates, so it never blocks, locks or allocates. A
+// snapshot is exact for each counter, though counters recorded between its reads may not agree.
+//
+// Each kind of record comes from a single thread: callbacks from the audio callback, ticks and
+// renders from whichever thread renders the Player.
+class PerfCounters {
+  public:
+    // Callback durations fall into buckets doubling in width: under 32 us, under 64 us and so
+    // on, with the last bucket taking everything from 32 ms up
+    static constexpr size_t histogram_buckets = 12;
+    static constexpr std::chrono::microseconds first_bucket_limit{32};
+
+    struct Snapshot {
+        uint64_t callbacks = 0;
+        uint64_t deadline_misses = 0;
+        uint64_t underflows = 0;
+        uint64_t overflows = 0;
+        int64_t callback_ns = 0;
+        int64_t max_callback_ns = 0;
+        int64_t deadline_ns = 0;
+        std::array<uint64_t, histogram_buckets> histogram{};
+
+        uint64_t renders = 0;
+        uint64_t rendered_frames = 0;
+        int64_t render_ns = 0;
+
+        uint64_t ticks = 0;
+        int64_t tick_ns = 0;
+        int64_t max_tick_ns = 0;
+        uint64_t events = 0;
+        uint64_t active_voices = 0;
+        uint64_t max_active_voices = 0;
+    };
+
+    // An audio callback that took `took` to fill a buffer lasting `deadline`
+    void record_callback(std::chrono::nanoseconds took, std::chrono::nanoseconds deadline);
+    // The audio device ran out of output to play, or had to drop some
+    void record_underflow() { _underflows.fetch_add(1, std::memory_order_relaxed); }
+    void record_overflow() { _overflows.fetch_add(1, std::memory_order_relaxed); }
+    // A render of `frames` frames, the ticks it processed included
+    void record_render(std::chrono::nanoseconds took, size_t frames);
+    // A tick within a recorded render that raised `events` mixer events, leaving
+    // `active_voices` voices playing
+    void record_tick(std::chrono::nanoseconds took, size_t events, size_t active_voices);
+
+    Snapshot snapshot() const;
+
+    static size_t histogram_bucket(std::chrono::nanoseconds duration);
+
+  private:
+    std::atomic<uint64_t> _callbacks{0};
+    std::atomic<uint64_t> _deadline_misses{0};
+    std::atomic<uint64_t> _underflows{0};
+    std::atomic<uint64_t> _overflows{0};
+    std::atomic<int64_t> _callback_ns{0};
+    std::atomic<int64_t> _max_callback_ns{0};
+    std::atomic<int64_t> _deadline_ns{0};
+    std::array<std::atomic<uint64_t>, histogram_buckets> _histogram{};
+
+    std::atomic<uint64_t> _renders{0};
+    std::atomic<uint64_t> _rendered_frames{0};
+    std::atomic<int64_t> _render_ns{0};
+
+    std::atomic<uint64_t> _ticks{0};
+    std::atomic<int64_t> _tick_ns{0};
+    std::atomic<int64_t> _max_tick_ns{0};
+    std::atomic<uint64_t> _events{0};
+    std::atomic<uint64_t> _active_voices{0};
+    std::atomic<uint64_t> _max_active_voices{0};
+};
+
+// A summary: deadline misses and underflows, where render time goes between ticks and mixing,
+// voice and event counts, and the callback duration histogram
+extern std::ostream& operator<<(std::ostream& os, const PerfCounters::Snapshot& snapshot);
+
+#endif
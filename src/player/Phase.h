@@ -0,0 +1,37 @@
+#ifndef _PLAYER_PHASE_H_
+#define _PLAYER_PHASE_H_
+
+#include <cstddef>
+#include <cstdint>
+
+// Voice positions are 32.32 fixed point: the frame in the top 32 bits and the fraction of the
+// way to the next in the bottom 32. Stepping is an integer add, so pitch stays exact however
+// far into a sample a voice gets, up to 2^32 frames, and the frame is a shift away.
+struct Phase {
+    using Position = uint64_t;
+
+    static constexpr Position one = Position{1} << 32;
+
+    static Position position(float index)
+    {
+        return static_cast<Position>(static_cast<double>(index) * static_cast<double>(one));
+    }
+    static float index(Position position)
+    {
+        return static_cast<float>(static_cast<double>(position) / static_cast<double>(one));
+    }
+    static size_t whole(Position position) { return static_cast<size_t>(position >> 32); }
+    static Position frames(size_t count) { return static_cast<Position>(count) << 32; }
+    static Position rate(float frequency, unsigned int sample_rate)
+    {
+        return static_cast<Position>(static_cast<double>(frequency) * static_cast<double>(one) /
+                                     static_cast<double>(sample_rate));
+    }
+    // The fraction as a float in [0, 1), to the 24 bits a float holds
+    static float fraction(Position position)
+    {
+        return static_cast<float>(static_cast<uint32_t>(position) >> 8) * (1.0f / 16777216.0f);
+    }
+};
+
+#endif
@@ -1,6 +1,9 @@
 #include "Player.h"
 #include "Mixer.h"
 #include "Module.h"
+#include "PerfCounters.h"
+#include "SeekIndex.h"
+#include "Tracer.h"
 
 #include <algorithm>
 #include <iostream>
@@ -22,6 +25,18 @@ static const int8_t sine_table[256] = {
     -14, -12, -11, -9,  -8,  -6,  -5,  -3,  -2,
 };
 
+// Processing an empty entry at the start of a row changes nothing about a channel without
+// these, and neither do the ticks after it
+static bool has_running_effects(const Player::Channel& channel)
+{
+    const auto& effects = channel.effects;
+    return effects.volume_slide_speed || effects.pitch_slide_speed || effects.vibrato.speed ||
+           effects.vibrato.depth || channel.period_offset || effects.arrpegio_offsets[1] ||
+           effects.arrpegio_offsets[2];
+}
+
+static const PatternEntry empty_entry;
+
 Player::Player(const std::shared_ptr<Module>& mod)
     : module(std::const_pointer_cast<const Module>(mod)),
       speed(mod->initial_speed),
@@ -31,27 +46,270 @@ Player::Player(const std::shared_ptr<Module>& mod)
       current_row(0),
       current_order(0),
       process_row(0),
-      channels(32),
-      _mixer(44100, 32)
+      channels(mod->channel_count()),
+      _mixer(44100, mod->channel_count())
 {
+    _all_channels = channels.size() >= 64 ? ~uint64_t{0} : (uint64_t{1} << channels.size()) - 1;
+    mixer_events.reserve(channels.size() * max_events_per_channel);
+    _pattern_events.reserve(module->patterns.size());
+    for (const auto& pattern : module->patterns) {
+        _pattern_events.emplace_back(pattern);
+    }
     _mixer.attach_handler(this);
 }
 
-void Player::onAttachment(Mixer& audio)
+void Player::onAttachment(PlayerMixer& audio)
 {
     audio.set_samples_per_tick(static_cast<size_t>(2.5f * audio.sampling_rate() / tempo));
+    for (size_t c = 0; c < module->channel_panning.size() && c < channels.size(); ++c) {
+        audio.channel(c).set_panning(static_cast<float>(module->channel_panning[c]) / 64.0f);
+    }
 }
 
-void Player::onTick(Mixer& audio)
+void Player::onTick(PlayerMixer& audio)
 {
-    for (const auto& event : process_tick()) {
+    TraceSpan span("Player::onTick", "order", static_cast<int64_t>(current_order), "row",
+                   static_cast<int64_t>(current_row));
+    // Ticks skipped through while seeking aren't part of any render, so they go unrecorded
+    const bool timed = _perf_counters && _timing_render;
+    const auto start = timed ? std::chrono::steady_clock::now()
+                             : std::chrono::steady_clock::time_point();
+    drain_commands();
+    const auto& events = process_tick();
+    for (const auto& event : events) {
         audio.process_event(event);
     }
+    if (timed) {
+        _perf_counters->record_tick(std::chrono::steady_clock::now() - start, events.size(),
+                                    audio.active_voice_count());
+    }
+}
+
+template <typename Render> void Player::timed_render(Render&& render)
+{
+    if (!_perf_counters) {
+        render();
+        return;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    _timing_render = true;
+    const size_t frames = render();
+    _timing_render = false;
+    _perf_counters->record_render(std::chrono::steady_clock::now() - start, frames);
+}
+
+bool Player::begin_render()
+{
+    // No ticks come round while paused, so commands are picked up here instead
+    if (is_paused()) {
+        drain_commands();
+    }
+    seek_pending();
+    return !is_paused();
 }
 
 void Player::render_audio(float* buffer, int framesToRender)
 {
-    _mixer.render(buffer, static_cast<size_t>(framesToRender));
+    if (!begin_render()) {
+        std::fill_n(buffer, framesToRender, 0.0f);
+        return;
+    }
+    const auto frames = static_cast<size_t>(framesToRender);
+    timed_render([&] {
+        _mixer.render(buffer, frames);
+        return frames;
+    });
+}
+
+void Player::render_stereo_audio(float* buffer, int framesToRender)
+{
+    if (!begin_render()) {
+        std::fill_n(buffer, 2 * framesToRender, 0.0f);
+        return;
+    }
+    const auto frames = static_cast<size_t>(framesToRender);
+    timed_render([&] {
+        _mixer.render_stereo(buffer, frames);
+        return frames;
+    });
+}
+
+size_t Player::render_stereo_until(float* buffer, size_t frames, StopCheck stop, void* context)
+{
+    if (!begin_render()) {
+        std::fill_n(buffer, 2 * frames, 0.0f);
+        return frames;
+    }
+    size_t rendered = 0;
+    timed_render([&] {
+        rendered = _mixer.render_stereo_until(buffer, frames, [&] { return stop(context); });
+        return rendered;
+    });
+    return rendered;
+}
+
+void Player::seek_pending()
+{
+    if (_pending_seek_frame && _seek_index) {
+        const size_t frame = *_pending_seek_frame;
+        _pending_seek_frame.reset();
+        _seek_index->seek(*this, frame);
+    }
+}
+
+void Player::save(State& state) const
+{
+    state.speed = speed;
+    state.tempo = tempo;
+    state.tick_counter = tick_counter;
+    state.break_row = break_row;
+    state.current_row = current_row;
+    state.current_order = current_order;
+    state.process_row = process_row;
+    state.wrapped = _wrapped;
+    state.channels = channels;
+    _mixer.save(state.mixer);
+}
+
+void Player::restore(const State& state)
+{
+    speed = state.speed;
+    tempo = state.tempo;
+    tick_counter = state.tick_counter;
+    break_row = state.break_row;
+    current_row = state.current_row;
+    current_order = state.current_order;
+    process_row = state.process_row;
+    _wrapped = state.wrapped;
+    for (size_t c = 0; c < channels.size() && c < state.channels.size(); ++c) {
+        const bool muted = channels[c].muted;
+        const bool soloed = channels[c].soloed;
+        channels[c] = state.channels[c];
+        channels[c].muted = muted;
+        channels[c].soloed = soloed;
+    }
+    _running_effects = 0;
+    for (size_t c = 0; c < channels.size(); ++c) {
+        if (has_running_effects(channels[c])) {
+            _running_effects |= uint64_t{1} << c;
+        }
+    }
+    _mixer.restore(state.mixer);
+    for (size_t c = 0; c < channels.size(); ++c) {
+        _mixer.channel(c).set_volume(mix_volume(channels[c]));
+    }
+}
+
+bool Player::send(const PlayerCommand::Action& action)
+{
+    return _commands.push({action, std::chrono::steady_clock::now()});
+}
+
+std::chrono::nanoseconds Player::command_latency() const
+{
+    return std::chrono::nanoseconds(_command_latency_ns.load(std::memory_order_relaxed));
+}
+
+std::chrono::nanoseconds Player::max_command_latency() const
+{
+    return std::chrono::nanoseconds(_max_command_latency_ns.load(std::memory_order_relaxed));
+}
+
+void Player::drain_commands()
+{
+    PlayerCommand command;
+    while (_commands.pop(command)) {
+        apply(command.action);
+
+        const auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                 std::chrono::steady_clock::now() - command.sent)
+                                 .count();
+        _command_latency_ns.store(latency, std::memory_order_relaxed);
+        if (latency > _max_command_latency_ns.load(std::memory_order_relaxed)) {
+            _max_command_latency_ns.store(latency, std::memory_order_relaxed);
+        }
+    }
+}
+
+void Player::apply(const PlayerCommand::Action& action)
+{
+    struct CommandInterpreter {
+        void operator()(const PlayerCommand::Pause& pause)
+        {
+            p._paused.store(pause.paused, std::memory_order_relaxed);
+        }
+        void operator()(const PlayerCommand::Seek& seek)
+        {
+            if (p._seek_index) {
+                if (const auto frame = p._seek_index->frame_of(seek.order, seek.row)) {
+                    p._pending_seek_frame = frame;
+                    return;
+                }
+            }
+            const auto& order = p.module->patternOrder;
+            if (seek.order >= order.size() || order[seek.order] >= p.module->patterns.size() ||
+                seek.row >= p.module->patterns[order[seek.order]].row_count()) {
+                return;
+            }
+            // The row plays from its first tick, as it would after a pattern break
+            p.current_order = seek.order;
+            p.current_row = seek.row;
+            p.process_row = seek.row;
+            p.break_row = 0;
+            p.tick_counter = 1;
+        }
+        void operator()(const PlayerCommand::SetTempo& set_tempo)
+        {
+            if (set_tempo.tempo > 0) {
+                p.set_tempo(set_tempo.tempo);
+            }
+        }
+        void operator()(const PlayerCommand::Mute& mute)
+        {
+            if (mute.channel < p.channels.size()) {
+                p.channels[mute.channel].muted = mute.muted;
+                p._volumes_changed = true;
+            }
+        }
+        void operator()(const PlayerCommand::Solo& solo)
+        {
+            if (solo.channel < p.channels.size()) {
+                p.channels[solo.channel].soloed = solo.soloed;
+                p._any_soloed = std::any_of(p.channels.begin(), p.channels.end(),
+                                            [](const Channel& c) { return c.soloed; });
+                p._volumes_changed = true;
+            }
+        }
+        void operator()(const PlayerCommand::SetMasterVolume& set_volume)
+        {
+            p._master_volume = std::clamp(set_volume.volume, 0.0f, 1.0f);
+            p._volumes_changed = true;
+        }
+        void operator()(const PlayerCommand::SeekTime& seek)
+        {
+            if (p._seek_index && seek.seconds >= 0) {
+                p._pending_seek_frame =
+                    static_cast<size_t>(seek.seconds * p._mixer.sampling_rate());
+            }
+        }
+        Player& p;
+    };
+
+    std::visit(CommandInterpreter{*this}, action);
+}
+
+void Player::set_tempo(int new_tempo)
+{
+    tempo = new_tempo;
+    _mixer.set_samples_per_tick(static_cast<size_t>(2.5f * _mixer.sampling_rate() / tempo));
+}
+
+float Player::mix_volume(const Channel& channel) const
+{
+    if (channel.muted || (_any_soloed && !channel.soloed)) {
+        return 0;
+    }
+    return static_cast<float>(channel.volume) / 64.0f * _master_volume;
 }
 
 void Player::process_global_command(const PatternEntry::Effect& effect)
@@ -72,8 +330,7 @@ void Player::process_global_command(const PatternEntry::Effect& effect)
         break_row = effect.data;
         break;
     case PatternEntry::Command::set_tempo:
-        tempo = effect.data;
-        _mixer.set_samples_per_tick(static_cast<size_t>(2.5f * _mixer.sampling_rate() / tempo));
+        set_tempo(effect.data);
         break;
     default:
         break;
@@ -239,18 +496,41 @@ static void update_effects(Player::Channel& channel, int tick)
 
 const std::vector<Mixer::Event>& Player::process_tick()
 {
+    TraceSpan span("Player::process_tick");
     mixer_events.clear();
 
     bool initial_tick = --tick_counter == 0;
     if (initial_tick) {
         tick_counter = speed;
+        if (_wrapped) {
+            ++times_looped;
+            _wrapped = false;
+        }
     }
 
-    const auto& current_pattern = module->patterns[module->patternOrder[current_order]];
-    for (size_t channel_index = 0; channel_index < current_pattern.channel_count();
-         ++channel_index) {
+    // Only channels with something in the row, or with effects running, change. A channel with
+    // effects running and nothing in the row still starts the row, which stops its effects.
+    uint64_t changing = _running_effects;
+    PatternEvents::Row row{};
+    if (initial_tick) {
+        row = _pattern_events[module->patternOrder[current_order]].row(current_row);
+        changing |= row.channels;
+        if (row.has_global_commands) {
+            for (const auto& cell : row) {
+                process_global_command(cell.entry.effect);
+            }
+        }
+    }
+    if (_volumes_changed) {
+        changing = _all_channels;
+    }
+    // Everything changing, less the channels whose effects turn out to have stopped
+    uint64_t running = changing;
 
-        auto& channel = channels[static_cast<size_t>(channel_index)];
+    const auto* cell = row.begin();
+    for (; changing; changing &= changing - 1) {
+        const auto channel_index = static_cast<size_t>(__builtin_ctzll(changing));
+        auto& channel = channels[channel_index];
 
         auto last_volume = channel.volume;
         auto last_frequency = channel.frequency;
@@ -258,9 +538,11 @@ const std::vector<Mixer::Event>& Player::process_tick()
         channel.effects.sample_offset = 0;
 
         if (initial_tick) {
-            const auto& entry = current_pattern.channel(channel_index).row(current_row);
-            process_global_command(entry.effect);
-            process_initial_tick(channel, entry);
+            if (cell != row.end() && cell->channel == channel_index) {
+                process_initial_tick(channel, (cell++)->entry);
+            } else {
+                process_initial_tick(channel, empty_entry);
+            }
         } else {
             update_effects(channel, speed - tick_counter);
         }
@@ -271,32 +553,37 @@ const std::vector<Mixer::Event>& Player::process_tick()
 
         if (channel.note_on || channel.frequency != last_frequency) {
             if (channel.note_on) {
-                mixer_events.push_back({static_cast<size_t>(channel_index),
+                mixer_events.push_back({channel_index,
                                         ::Channel::Event::SetNoteOn{
                                             static_cast<float>(channel.frequency),
                                             &(module->samples[channel.last_inst - 1].sample)}});
                 channel.note_on = false;
             } else {
                 mixer_events.push_back(
-                    {static_cast<size_t>(channel_index),
+                    {channel_index,
                      ::Channel::Event::SetFrequency{static_cast<float>(channel.frequency)}});
             }
         }
 
         channel.volume =
             std::clamp(channel.volume, static_cast<int8_t>(0), static_cast<int8_t>(64));
-        if (channel.volume != last_volume) {
+        if (channel.volume != last_volume || _volumes_changed) {
             mixer_events.push_back(
-                {static_cast<size_t>(channel_index),
-                 ::Channel::Event::SetVolume{static_cast<float>(channel.volume) / 64.0f}});
+                {channel_index, ::Channel::Event::SetVolume{mix_volume(channel)}});
         }
 
         if (channel.effects.sample_offset > 0) {
             mixer_events.push_back(
-                {static_cast<size_t>(channel_index),
-                 ::Channel::Event::SetSampleIndex{channel.effects.sample_offset}});
+                {channel_index, ::Channel::Event::SetSampleIndex{channel.effects.sample_offset}});
+        }
+
+        if (!has_running_effects(channel)) {
+            running &= ~(uint64_t{1} << channel_index);
         }
     }
+    _running_effects = running;
+
+    _volumes_changed = false;
 
     if (initial_tick) {
         if (process_row == 0xFFFE ||
@@ -306,6 +593,7 @@ const std::vector<Mixer::Event>& Player::process_tick()
             // TODO: End of order value 255 needs a name
             if (module->patternOrder[current_order] == 255) {
                 current_order = 0;
+                _wrapped = true;
             }
             process_row = break_row;
             break_row = 0;
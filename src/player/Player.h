@@ -3,18 +3,66 @@
 
 #include <player/Mixer.h>
 #include <player/PatternEntry.h>
+#include <player/PatternEvents.h>
+#include <player/SpscQueue.h>
 
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <optional>
 #include <variant>
 #include <vector>
 
+// The player mixes in floating point unless built with IMPULSE_FIXED_POINT, which swaps in the
+// bit exact integer pipeline
+#ifdef IMPULSE_FIXED_POINT
+using PlayerMixer = FixedPointMixer;
+#else
+using PlayerMixer = Mixer;
+#endif
+
+// Transport and mix controls a control thread sends a playing Player through Player::send()
+struct PlayerCommand {
+    struct Pause {
+        bool paused;
+    };
+    struct Seek {
+        size_t order;
+        size_t row;
+    };
+    struct SetTempo {
+        int tempo;
+    };
+    struct Mute {
+        size_t channel;
+        bool muted;
+    };
+    struct Solo {
+        size_t channel;
+        bool soloed;
+    };
+    struct SetMasterVolume {
+        float volume;
+    };
+    // Needs a SeekIndex, see Player::set_seek_index()
+    struct SeekTime {
+        double seconds;
+    };
+    using Action = std::variant<Pause, Seek, SetTempo, Mute, Solo, SetMasterVolume, SeekTime>;
+
+    Action action;
+    std::chrono::steady_clock::time_point sent;
+};
+
 struct Module;
-struct Player : public Mixer::TickHandler {
+class PerfCounters;
+class SeekIndex;
+struct Player : public PlayerMixer::TickHandler {
 
   public:
-    void onAttachment(Mixer& audio) override;
-    void onTick(Mixer& audio) override;
+    void onAttachment(PlayerMixer& audio) override;
+    void onTick(PlayerMixer& audio) override;
 
     struct Channel {
 
@@ -52,11 +100,19 @@ struct Player : public Mixer::TickHandler {
         int period_offset = 0;
         int8_t volume = 64;
         float frequency = 0;
+        bool muted = false;
+        bool soloed = false;
     };
 
     Player(const std::shared_ptr<Module>& mod);
 
     void render_audio(float*, int);
+    // Interleaved left/right frames
+    void render_stereo_audio(float*, int);
+    // Renders as render_stereo_audio does, but stops short of the first tick for which
+    // stop(context) is true. Returns the frames rendered.
+    using StopCheck = bool (*)(void* context);
+    size_t render_stereo_until(float* buffer, size_t frames, StopCheck stop, void* context);
 
     static int calculate_period(const PatternEntry::Note& note, const int c5_speed);
     void process_global_command(const PatternEntry::Effect& effect);
@@ -64,7 +120,49 @@ struct Player : public Mixer::TickHandler {
 
     const std::vector<Mixer::Event>& process_tick();
 
-    const Mixer& mixer() const { return _mixer; }
+    const PlayerMixer& mixer() const { return _mixer; }
+
+    // Queues a command from the control thread without blocking. The audio thread picks
+    // commands up at the next tick, or at the next render while paused, so they land within a
+    // tick and a callback buffer of being sent. Returns false, dropping the command, if the
+    // audio thread has command_capacity commands still to pick up.
+    bool send(const PlayerCommand::Action& action);
+    static constexpr size_t command_capacity = 64;
+    // Time from send() to the audio thread acting on the most recent command, and the longest
+    // so far
+    std::chrono::nanoseconds command_latency() const;
+    std::chrono::nanoseconds max_command_latency() const;
+    bool is_paused() const { return _paused.load(std::memory_order_relaxed); }
+
+    // Everything playback carries from one tick to the next, short of the mute, solo and
+    // master volume settings
+    struct State {
+        int speed = 0;
+        int tempo = 0;
+        int tick_counter = 0;
+        size_t break_row = 0;
+        size_t current_row = 0;
+        size_t current_order = 0;
+        size_t process_row = 0;
+        bool wrapped = false;
+        std::vector<Channel> channels;
+        PlayerMixer::State mixer;
+    };
+    void save(State& state) const;
+    // Carries on from a State saved by a Player of the same module, keeping this one's mute,
+    // solo and master volume settings. Allocates nothing once `channels` is sized.
+    void restore(const State& state);
+    // Moves playback on by `frames` frames, ticks and all, without rendering them
+    void skip(size_t frames) { _mixer.skip(frames); }
+
+    // With an index of this Player's module, Seek commands land with every effect, tempo and
+    // voice as playing up to the row would have left them, and SeekTime commands work.
+    // Indexed seeks happen at the start of the next render. Set it before playback starts.
+    void set_seek_index(std::shared_ptr<const SeekIndex> index) { _seek_index = std::move(index); }
+
+    // Records how long each render and tick takes into `counters`, until set back to nullptr.
+    // Set it before playback starts.
+    void set_perf_counters(PerfCounters* counters) { _perf_counters = counters; }
 
     std::shared_ptr<const Module> module;
     int speed;
@@ -75,13 +173,51 @@ struct Player : public Mixer::TickHandler {
     size_t current_order;
     size_t process_row;
     std::vector<Channel> channels;
+    // Times playback has run off the end of the order list and come back round to the start
+    size_t times_looped = 0;
+    // A tick raises at most a note on or frequency change, a volume change and a sample offset
+    // per channel. mixer_events is reserved for that many at construction, so ticks processed
+    // from the audio callback never allocate.
+    static constexpr size_t max_events_per_channel = 3;
     std::vector<Mixer::Event> mixer_events;
 
   private:
     int sample_playback_rate(int sample_number) const;
+    void set_tempo(int new_tempo);
+    float mix_volume(const Channel& channel) const;
+    void drain_commands();
+    void apply(const PlayerCommand::Action& action);
+    // Picks up commands and seeks ahead of a render. False while paused.
+    bool begin_render();
+    // Runs `render`, which returns the frames it rendered, recording it in the perf counters
+    template <typename Render> void timed_render(Render&& render);
+    void seek_pending();
 
   private:
-    Mixer _mixer;
+    PlayerMixer _mixer;
+
+    SpscQueue<PlayerCommand, command_capacity> _commands;
+    std::atomic<bool> _paused{false};
+    std::atomic<int64_t> _command_latency_ns{0};
+    std::atomic<int64_t> _max_command_latency_ns{0};
+    float _master_volume = 1.0f;
+    bool _any_soloed = false;
+    // Set once the order list wraps, counted when the first row after the wrap starts
+    bool _wrapped = false;
+    // Mute, solo and master volume changes resend every channel's volume at the next tick
+    bool _volumes_changed = false;
+    // Every pattern of the module, compiled when the Player is made
+    std::vector<PatternEvents> _pattern_events;
+    // Bit c set while channel c has effects changing it from tick to tick
+    uint64_t _running_effects = 0;
+    // Bit c set for each of the module's channels
+    uint64_t _all_channels = 0;
+    PerfCounters* _perf_counters = nullptr;
+    // Set while timed_render runs, so only the ticks inside a recorded render are recorded
+    bool _timing_render = false;
+    std::shared_ptr<const SeekIndex> _seek_index;
+    // Seeks through the index wait for the next render, outside of the mixer's tick
+    std::optional<size_t> _pending_seek_frame;
 };
 
 #endif
\ No newline at end of file
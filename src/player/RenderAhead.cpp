@@ -0,0 +1,88 @@
+#include "RenderAhead.h"
+#include "Player.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+
+static size_t ring_frames_for(size_t frames)
+{
+    size_t ring_frames = 1;
+    while (ring_frames < frames) {
+        ring_frames *= 2;
+    }
+    return ring_frames;
+}
+
+RenderAhead::RenderAhead(Player& player, size_t lookahead_frames, size_t block_frames)
+    : _player(player),
+      _lookahead_frames(std::max(lookahead_frames, block_frames)),
+      _block_frames(block_frames),
+      _ring(2 * ring_frames_for(_lookahead_frames)),
+      _ring_mask(ring_frames_for(_lookahead_frames) - 1),
+      _block(2 * block_frames)
+{
+    while (render_block())
+        ;
+    _thread = std::thread([this] { run(); });
+}
+
+RenderAhead::~RenderAhead()
+{
+    _running.store(false, std::memory_order_relaxed);
+    _thread.join();
+}
+
+size_t RenderAhead::fill_level() const
+{
+    return _written.load(std::memory_order_acquire) - _read.load(std::memory_order_acquire);
+}
+
+void RenderAhead::read(float* out, size_t frames)
+{
+    const size_t read = _read.load(std::memory_order_relaxed);
+    const size_t ready = std::min(frames, _written.load(std::memory_order_acquire) - read);
+
+    // In up to two pieces, either side of the end of the ring
+    const size_t start = read & _ring_mask;
+    const size_t first = std::min(ready, _ring_mask + 1 - start);
+    std::copy_n(&_ring[2 * start], 2 * first, out);
+    std::copy_n(&_ring[0], 2 * (ready - first), out + 2 * first);
+    _read.store(read + ready, std::memory_order_release);
+
+    if (ready < frames) {
+        std::fill_n(out + 2 * ready, 2 * (frames - ready), 0.0f);
+        _underruns.fetch_add(1, std::memory_order_relaxed);
+        _underrun_frames.fetch_add(frames - ready, std::memory_order_relaxed);
+    }
+}
+
+// Renders a block into the ring if it has room for one under the lookahead
+bool RenderAhead::render_block()
+{
+    const size_t written = _written.load(std::memory_order_relaxed);
+    if (written - _read.load(std::memory_order_acquire) + _block_frames > _lookahead_frames) {
+        return false;
+    }
+    _player.render_stereo_audio(_block.data(), static_cast<int>(_block_frames));
+
+    const size_t start = written & _ring_mask;
+    const size_t first = std::min(_block_frames, _ring_mask + 1 - start);
+    std::copy_n(_block.begin(), 2 * first, &_ring[2 * start]);
+    std::copy_n(_block.begin() + static_cast<std::ptrdiff_t>(2 * first),
+                2 * (_block_frames - first), &_ring[0]);
+    _written.store(written + _block_frames, std::memory_order_release);
+    return true;
+}
+
+void RenderAhead::run()
+{
+    // Once the ring is full, check back every quarter of a block's playing time
+    const auto idle = std::chrono::microseconds(_block_frames * 250000 /
+                                                _player.mixer().sampling_rate());
+    while (_running.load(std::memory_order_relaxed)) {
+        if (!render_block()) {
+            std::this_thread::sleep_for(idle);
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef _PLAYER_RENDER_AHEAD_H_
+#define _PLAYER_RENDER_AHEAD_H_
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+struct Player;
+
+// Renders a Player ahead of playback on a thread of its own, so a heavy tick eats into frames
+// already rendered instead of the audio callback's deadline. The callback only copies frames
+// out with read(), which never blocks, locks or allocates. Should the render thread fall behind
+// anyway, read() pads with silence and counts an underrun.
+//
+// Commands sent to the Player take effect as it renders, so they reach the output up to the
+// lookahead later than they would rendering in the callback.
+class RenderAhead {
+  public:
+    // Keeps up to `lookahead_frames` interleaved stereo frames rendered ahead, rendering
+    // `block_frames` at a time. The lookahead is filled before the constructor returns.
+    RenderAhead(Player& player, size_t lookahead_frames, size_t block_frames = 256);
+    ~RenderAhead();
+
+    RenderAhead(const RenderAhead&) = delete;
+    RenderAhead& operator=(const RenderAhead&) = delete;
+
+    // Copies the next `frames` interleaved stereo frames into `out`
+    void read(float* out, size_t frames);
+
+    size_t lookahead_frames() const { return _lookahead_frames; }
+    // Frames rendered and not yet read
+    size_t fill_level() const;
+    // Reads that found fewer frames ready than they asked for, and the frames they missed
+    size_t underruns() const { return _underruns.load(std::memory_order_relaxed); }
+    size_t underrun_frames() const { return _underrun_frames.load(std::memory_order_relaxed); }
+
+  private:
+    bool render_block();
+    void run();
+
+  private:
+    Player& _player;
+    const size_t _lookahead_frames;
+    const size_t _block_frames;
+
+    // A power of two frames long, so positions wrap with a mask
+    std::vector<float> _ring;
+    size_t _ring_mask;
+    std::vector<float> _block;
+
+    // Frames read and written since the start. Each side writes its own on its own cache line.
+    alignas(64) std::atomic<size_t> _read{0};
+    alignas(64) std::atomic<size_t> _written{0};
+
+    std::atomic<size_t> _underruns{0};
+    std::atomic<size_t> _underrun_frames{0};
+    std::atomic<bool> _running{true};
+    std::thread _thread;
+};
+
+#endif
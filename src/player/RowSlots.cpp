@@ -0,0 +1,23 @@
+#include "RowSlots.h"
+#include "Module.h"
+
+RowSlots::RowSlots(const Module& module)
+{
+    size_t slots = 0;
+    for (const auto pattern : module.patternOrder) {
+        _order_offsets.push_back(slots);
+        if (pattern < module.patterns.size()) {
+            slots += module.patterns[pattern].row_count();
+        }
+    }
+    _order_offsets.push_back(slots);
+}
+
+std::optional<size_t> RowSlots::slot(size_t order, size_t row) const
+{
+    if (order + 1 >= _order_offsets.size() ||
+        row >= _order_offsets[order + 1] - _order_offsets[order]) {
+        return std::nullopt;
+    }
+    return _order_offsets[order] + row;
+}
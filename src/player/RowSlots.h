@@ -0,0 +1,26 @@
+#ifndef _PLAYER_ROW_SLOTS_H_
+#define _PLAYER_ROW_SLOTS_H_
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+struct Module;
+
+// Numbers every row of every order in a module's order list consecutively, so per row tables
+// can be flat vectors. The same pattern at two orders takes two sets of slots.
+class RowSlots {
+  public:
+    explicit RowSlots(const Module& module);
+
+    // The row's slot, or none for an order past the end of the list or a row past the end of
+    // its pattern
+    std::optional<size_t> slot(size_t order, size_t row) const;
+    size_t size() const { return _order_offsets.back(); }
+
+  private:
+    // Each order's rows take consecutive slots from _order_offsets[order]
+    std::vector<size_t> _order_offsets;
+};
+
+#endif
@@ -1,6 +1,9 @@
 #ifndef _SAMPLE_H_
 #define _SAMPLE_H_
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <vector>
 
 class Sample {
@@ -24,23 +27,37 @@ class Sample {
     };
 
   public:
+    // Frames of padding either side of the played frames. Before the start they are silence;
+    // past the loop end they repeat the loop from its start, or are silence for one shots. An
+    // interpolator can read its taps around any position short of the loop end without
+    // checking for either edge.
+    static constexpr size_t guard_frames = 16;
+
     template <typename Iterator>
     Sample(Iterator b, Iterator e, size_t playbackRate, LoopParams loopParams = LoopParams())
         : _data(b, e),
+          _length(_data.size()),
           _playbackRate(playbackRate),
           _loop{loopParams.type, loopParams.begin, loopParams.end ? loopParams.end : _data.size()}
     {
+        add_guards();
     }
     Sample(std::initializer_list<float> il, size_t playbackRate,
            LoopParams loopParams = LoopParams())
         : _data(il),
+          _length(_data.size()),
           _playbackRate(playbackRate),
           _loop{loopParams.type, loopParams.begin, loopParams.end ? loopParams.end : _data.size()}
     {
+        add_guards();
     }
 
     Sample(const Sample&& other)
-        : _data(other._data), _playbackRate(other._playbackRate), _loop(other._loop)
+        : _data(other._data),
+          _pcm16(other._pcm16),
+          _length(other._length),
+          _playbackRate(other._playbackRate),
+          _loop(other._loop)
     {
     }
 
@@ -48,30 +65,75 @@ class Sample {
     {
         auto wholeI = static_cast<size_t>(i);
         float t = i - static_cast<float>(wholeI);
-        size_t nextIndex = wholeI + 1;
 
-        float v0 = _data[wholeI];
+        float v0 = (*this)[wholeI];
         float v1 = 0;
-        if (nextIndex >= loopEnd()) {
-            if (_loop.type == LoopParams::Type::forward_looping) {
-                nextIndex -= loopLength();
-                v1 = _data[nextIndex];
-            }
-            return v0 + t * (v1 - v0);
+        if (wholeI < loopEnd()) {
+            // The guard frames hold what follows the loop end
+            v1 = data()[wholeI + 1];
+        } else if (_loop.type == LoopParams::Type::forward_looping && loopLength()) {
+            v1 = (*this)[wholeI + 1 - loopLength()];
         }
-        v1 = _data[nextIndex];
         return v0 + t * (v1 - v0);
     }
-    inline float operator[](size_t i) const { return _data[i]; }
-    inline size_t length() const { return _data.size(); }
+    inline float operator[](size_t i) const
+    {
+        // Frames past the loop end are stored after its guard frames
+        return data()[i < loopEnd() ? i : i + guard_frames];
+    }
+    // Frame 0 of the played frames, with guard_frames readable either side of [0, loopEnd())
+    inline const float* data() const { return _data.data() + guard_frames; }
+    // The frames as 16 bit integers, for fixed point mixing, laid out as data(). Only samples
+    // made in a build with IMPULSE_FIXED_POINT, or given add_pcm16(), have them.
+    inline const int16_t* pcm16() const { return _pcm16.data() + guard_frames; }
+    inline bool has_pcm16() const { return !_pcm16.empty(); }
+    void add_pcm16()
+    {
+        _pcm16.clear();
+        _pcm16.reserve(_data.size());
+        for (auto v : _data) {
+            auto clamped = v < -1.0f ? -1.0f : (v > 1.0f ? 1.0f : v);
+            _pcm16.push_back(static_cast<int16_t>(std::lrint(clamped * 32767.0f)));
+        }
+    }
+    inline size_t length() const { return _length; }
     inline LoopParams::Type loopType() const { return _loop.type; }
     inline size_t loopBegin() const { return _loop.begin; }
     inline size_t loopEnd() const { return _loop.end; }
     inline size_t loopLength() const { return loopEnd() - loopBegin(); }
     inline size_t playbackRate() const { return _playbackRate; }
 
+  private:
+    void add_guards()
+    {
+        _loop.end = std::min(_loop.end, _length);
+        _loop.begin = std::min(_loop.begin, _loop.end);
+
+        _data = with_guards(_data);
+#ifdef IMPULSE_FIXED_POINT
+        add_pcm16();
+#endif
+    }
+
+    template <typename T> std::vector<T> with_guards(const std::vector<T>& frames) const
+    {
+        std::vector<T> padded(_length + 2 * guard_frames);
+        std::copy(frames.begin(), frames.begin() + static_cast<long>(_loop.end),
+                  padded.begin() + guard_frames);
+        if (_loop.type == LoopParams::Type::forward_looping && loopLength()) {
+            for (size_t i = 0; i < guard_frames; ++i) {
+                padded[guard_frames + _loop.end + i] = frames[_loop.begin + i % loopLength()];
+            }
+        }
+        std::copy(frames.begin() + static_cast<long>(_loop.end), frames.end(),
+                  padded.begin() + static_cast<long>(2 * guard_frames + _loop.end));
+        return padded;
+    }
+
   private:
     std::vector<float> _data;
+    std::vector<int16_t> _pcm16;
+    size_t _length;
     size_t _playbackRate;
     LoopParams _loop;
 };
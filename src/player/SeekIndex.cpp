@@ -0,0 +1,68 @@
+#include "SeekIndex.h"
+#include "Module.h"
+
+#include <algorithm>
+#include <tuple>
+
+SeekIndex::SeekIndex(const std::shared_ptr<Module>& module, size_t rows_per_snapshot,
+                     double max_seconds)
+{
+    // The sequencer alone finds every row and where the song loops back. Only the snapshots
+    // need the voices played through.
+    const SongTimeline timeline(module);
+    const auto max_frames =
+        static_cast<size_t>(max_seconds * static_cast<double>(timeline.sample_rate()));
+    _song_ended = timeline.frames() <= max_frames;
+    _frames = std::min(timeline.frames(), max_frames);
+    for (const auto& row : timeline.rows()) {
+        if (row.frame >= _frames) {
+            break;
+        }
+        _rows.push_back(row);
+    }
+
+    // Each snapshot is taken ahead of the tick starting its row
+    rows_per_snapshot = std::max(rows_per_snapshot, size_t{1});
+    Player player(module);
+    Player::State state;
+    size_t frame = 0;
+    for (size_t r = 0; r < _rows.size(); r += rows_per_snapshot) {
+        player.skip(_rows[r].frame - frame);
+        frame = _rows[r].frame;
+        player.save(state);
+        _snapshots.push_back({frame, state});
+    }
+
+    _rows_by_position = _rows;
+    std::sort(_rows_by_position.begin(), _rows_by_position.end(),
+              [](const RowStart& a, const RowStart& b) {
+                  return std::tie(a.order, a.row, a.frame) < std::tie(b.order, b.row, b.frame);
+              });
+}
+
+std::optional<size_t> SeekIndex::frame_of(size_t order, size_t row) const
+{
+    const auto found = std::lower_bound(
+        _rows_by_position.begin(), _rows_by_position.end(), std::make_pair(order, row),
+        [](const RowStart& a, const std::pair<size_t, size_t>& position) {
+            return std::make_pair(size_t{a.order}, size_t{a.row}) < position;
+        });
+    if (found == _rows_by_position.end() || found->order != order || found->row != row) {
+        return std::nullopt;
+    }
+    return found->frame;
+}
+
+bool SeekIndex::seek(Player& player, size_t frame) const
+{
+    if (frame > _frames || _snapshots.empty()) {
+        return false;
+    }
+    const auto after = std::upper_bound(
+        _snapshots.begin(), _snapshots.end(), frame,
+        [](size_t target, const Snapshot& snapshot) { return target < snapshot.frame; });
+    const auto& snapshot = *(after - 1);
+    player.restore(snapshot.state);
+    player.skip(frame - snapshot.frame);
+    return true;
+}
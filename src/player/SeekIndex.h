@@ -0,0 +1,58 @@
+#ifndef _PLAYER_SEEK_INDEX_H_
+#define _PLAYER_SEEK_INDEX_H_
+
+#include "Player.h"
+#include "SongTimeline.h"
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <vector>
+
+struct Module;
+
+// Where every row of a song starts, in frames from the start, as a SongTimeline finds them,
+// and snapshots of the Player every few rows, found by playing the song up to where it loops
+// once with no mixing. Seeking restores the last snapshot before the target and skips the few
+// ticks from there, so a seek anywhere in a long song costs about as much as rendering a
+// handful of rows.
+class SeekIndex {
+  public:
+    static constexpr size_t default_rows_per_snapshot = 16;
+
+    // Scans until the song loops back to a row it has already played, or for `max_seconds`
+    // should that take longer
+    explicit SeekIndex(const std::shared_ptr<Module>& module,
+                       size_t rows_per_snapshot = default_rows_per_snapshot,
+                       double max_seconds = 3600);
+
+    using RowStart = SongTimeline::RowStart;
+    struct Snapshot {
+        size_t frame;
+        Player::State state;
+    };
+
+    // In the order they play
+    const std::vector<RowStart>& rows() const { return _rows; }
+    const std::vector<Snapshot>& snapshots() const { return _snapshots; }
+    // The frames scanned, up to where the song loops when song_ended()
+    size_t frames() const { return _frames; }
+    bool song_ended() const { return _song_ended; }
+
+    // Where the row first starts, if the song ever plays it
+    std::optional<size_t> frame_of(size_t order, size_t row) const;
+
+    // Moves a Player of the same module to `frame` frames into the song, as though it had
+    // played there from the start. Returns false, leaving it be, for a frame past the scan.
+    bool seek(Player& player, size_t frame) const;
+
+  private:
+    std::vector<RowStart> _rows;
+    // _rows sorted by order, row and frame, for frame_of()
+    std::vector<RowStart> _rows_by_position;
+    std::vector<Snapshot> _snapshots;
+    size_t _frames = 0;
+    bool _song_ended = false;
+};
+
+#endif
@@ -0,0 +1,43 @@
+#include "SongTimeline.h"
+#include "Module.h"
+#include "Player.h"
+
+SongTimeline::SongTimeline(const std::shared_ptr<Module>& module) : _slots(*module)
+{
+    _row_index.resize(_slots.size());
+
+    // The Player only sequences: its ticks raise mixer events that nothing applies, and each
+    // tick lasts as long as the tempo it leaves behind, as it would in a render
+    Player player(module);
+    _sample_rate = player.mixer().sampling_rate();
+    for (;;) {
+        if (player.tick_counter == 1) {
+            const size_t order = player.current_order;
+            const size_t row = player.current_row;
+            const auto slot = _slots.slot(order, row);
+            // A break to a row past the end of the pattern ends the song there
+            if (!slot) {
+                break;
+            }
+            auto& index = _row_index[*slot];
+            if (index) {
+                _loop_index = index - 1;
+                break;
+            }
+            _rows.push_back({_frames, static_cast<uint32_t>(order), static_cast<uint32_t>(row)});
+            index = _rows.size();
+        }
+        player.process_tick();
+        _frames += player.mixer().samples_per_tick();
+    }
+}
+
+std::optional<size_t> SongTimeline::frame_of(size_t order, size_t row) const
+{
+    const auto slot = _slots.slot(order, row);
+    const size_t index = slot ? _row_index[*slot] : 0;
+    if (!index) {
+        return std::nullopt;
+    }
+    return _rows[index - 1].frame;
+}
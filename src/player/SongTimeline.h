@@ -0,0 +1,66 @@
+#ifndef _PLAYER_SONG_TIMELINE_H_
+#define _PLAYER_SONG_TIMELINE_H_
+
+#include "RowSlots.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+struct Module;
+
+// How long a song plays and where it loops, found by running the sequencer on its own: ticks
+// only, with no voices mixed or even advanced, so a whole song takes a few milliseconds.
+//
+// Where playback goes next depends only on the row it is on, so the first row to come round a
+// second time is where the song loops back to, and every row before it plays exactly once.
+class SongTimeline {
+  public:
+    explicit SongTimeline(const std::shared_ptr<Module>& module);
+
+    struct RowStart {
+        size_t frame;
+        uint32_t order;
+        uint32_t row;
+    };
+
+    // Every row the song plays, in the order it plays them
+    const std::vector<RowStart>& rows() const { return _rows; }
+    // Frames from the start until the song loops back
+    size_t frames() const { return _frames; }
+    double seconds() const { return seconds_at(_frames); }
+    double seconds_at(size_t frame) const
+    {
+        return static_cast<double>(frame) / static_cast<double>(_sample_rate);
+    }
+    size_t sample_rate() const { return _sample_rate; }
+
+    // The row playback carries on from after the last of rows(), if it comes back round to
+    // one. Songs that play no rows, or end at a break past the end of a pattern, have none.
+    std::optional<RowStart> loop() const
+    {
+        if (!_loop_index) {
+            return std::nullopt;
+        }
+        return _rows[*_loop_index];
+    }
+    std::optional<size_t> loop_index() const { return _loop_index; }
+    // Whether the song comes back round to the start, as opposed to repeating only its end
+    bool loops_to_start() const { return _loop_index == size_t{0}; }
+
+    // Where the row starts, if the song plays it
+    std::optional<size_t> frame_of(size_t order, size_t row) const;
+
+  private:
+    std::vector<RowStart> _rows;
+    RowSlots _slots;
+    // By slot, one past the row's index in _rows, or 0 for a row never played
+    std::vector<size_t> _row_index;
+    size_t _frames = 0;
+    size_t _sample_rate = 0;
+    std::optional<size_t> _loop_index;
+};
+
+#endif
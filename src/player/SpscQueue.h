@@ -0,0 +1,48 @@
+#ifndef _PLAYER_SPSC_QUEUE_H_
+#define _PLAYER_SPSC_QUEUE_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// A fixed capacity ring handing values from one thread to another. One thread pushes, one
+// thread pops, and neither ever blocks, locks or allocates, so the popping side can be the
+// real-time audio callback.
+template <typename T, size_t Capacity> class SpscQueue {
+    static_assert(Capacity && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2");
+
+  public:
+    // Producer side. Returns false, leaving the queue as it was, when it is full.
+    bool push(const T& value)
+    {
+        const size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _head.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        _slots[tail % Capacity] = value;
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false when there is nothing to pop.
+    bool pop(T& value)
+    {
+        const size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = _slots[head % Capacity];
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+  private:
+    std::array<T, Capacity> _slots{};
+    // Each side writes its own index on its own cache line
+    alignas(64) std::atomic<size_t> _head{0};
+    alignas(64) std::atomic<size_t> _tail{0};
+};
+
+#endif
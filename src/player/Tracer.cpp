@@ -0,0 +1,138 @@
+#include "Tracer.h"
+
+#include <algorithm>
+#include <string>
+
+std::atomic<Tracer*> Tracer::_installed{nullptr};
+std::atomic<uint64_t> Tracer::_generations{0};
+
+// The ring each thread claimed, and from which Tracer, so a thread that outlives one Tracer
+// claims a fresh ring from the next
+struct ThreadRing {
+    uint64_t generation = 0;
+    void* ring = nullptr;
+};
+static thread_local ThreadRing this_thread_ring;
+
+static size_t ring_size_for(size_t spans)
+{
+    size_t size = 1;
+    while (size < spans) {
+        size *= 2;
+    }
+    return size;
+}
+
+Tracer::Tracer(std::ostream& out, size_t max_threads, size_t spans_per_thread,
+               std::chrono::milliseconds flush_interval)
+    : _out(out),
+      _generation(++_generations),
+      _start(std::chrono::steady_clock::now()),
+      _max_threads(max_threads),
+      _ring_mask(ring_size_for(spans_per_thread) - 1),
+      _rings(new Ring[max_threads])
+{
+    for (size_t t = 0; t < max_threads; ++t) {
+        _rings[t].spans.resize(_ring_mask + 1);
+    }
+    _out << "[";
+    _thread = std::thread([this, flush_interval] {
+        std::unique_lock<std::mutex> lock(_stop_mutex);
+        while (!_stop.wait_for(lock, flush_interval, [this] { return _stopping; })) {
+            flush();
+        }
+    });
+}
+
+Tracer::~Tracer()
+{
+    uninstall();
+    {
+        std::lock_guard<std::mutex> lock(_stop_mutex);
+        _stopping = true;
+    }
+    _stop.notify_one();
+    _thread.join();
+    flush();
+    _out << "\n]\n";
+    _out.flush();
+}
+
+void Tracer::install() { _installed.store(this, std::memory_order_release); }
+
+void Tracer::uninstall()
+{
+    Tracer* self = this;
+    _installed.compare_exchange_strong(self, nullptr, std::memory_order_acq_rel);
+}
+
+int64_t Tracer::now() const
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - _start)
+        .count();
+}
+
+Tracer::Ring* Tracer::ring_for_this_thread()
+{
+    if (this_thread_ring.generation != _generation) {
+        const size_t claimed = _claimed_rings.fetch_add(1, std::memory_order_relaxed);
+        this_thread_ring = {_generation, claimed < _max_threads ? &_rings[claimed] : nullptr};
+    }
+    return static_cast<Ring*>(this_thread_ring.ring);
+}
+
+void Tracer::record(const Span& span)
+{
+    Ring* ring = ring_for_this_thread();
+    if (ring == nullptr) {
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    const size_t tail = ring->tail.load(std::memory_order_relaxed);
+    if (tail - ring->head.load(std::memory_order_acquire) > _ring_mask) {
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    ring->spans[tail & _ring_mask] = span;
+    ring->tail.store(tail + 1, std::memory_order_release);
+}
+
+// Trace timestamps are in microseconds, kept to the nanosecond
+static std::string microseconds(int64_t ns)
+{
+    std::string fraction = std::to_string(ns % 1000);
+    return std::to_string(ns / 1000) + "." + std::string(3 - fraction.size(), '0') + fraction;
+}
+
+void Tracer::write(const Span& span, size_t thread)
+{
+    _out << (_first_event ? "\n" : ",\n") << R"({"name":")" << span.name
+         << R"(","ph":"X","pid":1,"tid":)" << thread << R"(,"ts":)" << microseconds(span.begin_ns)
+         << R"(,"dur":)" << microseconds(span.end_ns - span.begin_ns);
+    _first_event = false;
+    if (span.arg_names[0]) {
+        _out << R"(,"args":{")" << span.arg_names[0] << R"(":)" << span.args[0];
+        if (span.arg_names[1]) {
+            _out << R"(,")" << span.arg_names[1] << R"(":)" << span.args[1];
+        }
+        _out << "}";
+    }
+    _out << "}";
+}
+
+void Tracer::flush()
+{
+    std::lock_guard<std::mutex> lock(_flush_mutex);
+    const size_t claimed = std::min(_claimed_rings.load(std::memory_order_relaxed), _max_threads);
+    for (size_t t = 0; t < claimed; ++t) {
+        Ring& ring = _rings[t];
+        const size_t tail = ring.tail.load(std::memory_order_acquire);
+        size_t head = ring.head.load(std::memory_order_relaxed);
+        for (; head != tail; ++head) {
+            write(ring.spans[head & _ring_mask], t + 1);
+        }
+        ring.head.store(head, std::memory_order_release);
+    }
+    _out.flush();
+}
@@ -0,0 +1,117 @@
+#ifndef _PLAYER_TRACER_H_
+#define _PLAYER_TRACER_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+// Writes spans of work as Chrome trace events (chrome://tracing, ui.perfetto.dev), one track
+// per thread. Spans come from TraceSpans placed around mixer renders, ticks, voices and loader
+// phases, and only record while a Tracer is installed.
+//
+// Each thread records into a ring of its own, preallocated when the Tracer is built and
+// claimed by the thread's first span, so recording never blocks, locks or allocates. A thread
+// of the Tracer's own drains the rings to the output every flush interval. Spans that find
+// their ring full, or every ring claimed, are dropped and counted.
+class Tracer {
+  public:
+    struct Span {
+        // Names must outlive the Tracer; string literals do
+        const char* name = nullptr;
+        int64_t begin_ns = 0;
+        int64_t end_ns = 0;
+        std::array<const char*, 2> arg_names{};
+        std::array<int64_t, 2> args{};
+    };
+
+    explicit Tracer(std::ostream& out, size_t max_threads = 16, size_t spans_per_thread = 1 << 15,
+                    std::chrono::milliseconds flush_interval = std::chrono::milliseconds(50));
+    // Uninstalls, writes out the last spans and ends the trace. Stop whatever is recording
+    // first.
+    ~Tracer();
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    // Makes this the Tracer that TraceSpans record into
+    void install();
+    void uninstall();
+    static Tracer* installed() { return _installed.load(std::memory_order_acquire); }
+
+    // Nanoseconds since the Tracer was built
+    int64_t now() const;
+    void record(const Span& span);
+    // Writes out every span recorded so far. The flush thread calls it; so can anyone else.
+    void flush();
+    size_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+  private:
+    struct Ring {
+        std::vector<Span> spans;
+        alignas(64) std::atomic<size_t> head{0};
+        alignas(64) std::atomic<size_t> tail{0};
+    };
+
+    Ring* ring_for_this_thread();
+    void write(const Span& span, size_t thread);
+
+    static std::atomic<Tracer*> _installed;
+    static std::atomic<uint64_t> _generations;
+
+    std::ostream& _out;
+    const uint64_t _generation;
+    const std::chrono::steady_clock::time_point _start;
+    const size_t _max_threads;
+    const size_t _ring_mask;
+    std::unique_ptr<Ring[]> _rings;
+    std::atomic<size_t> _claimed_rings{0};
+    std::atomic<size_t> _dropped{0};
+
+    std::mutex _flush_mutex;
+    bool _first_event = true;
+    std::mutex _stop_mutex;
+    std::condition_variable _stop;
+    bool _stopping = false;
+    std::thread _thread;
+};
+
+// Records the span from its construction to its destruction into the installed Tracer, with
+// up to two integer arguments. Without a Tracer installed it costs an atomic load.
+class TraceSpan {
+  public:
+    explicit TraceSpan(const char* name, const char* arg_name = nullptr, int64_t arg = 0,
+                       const char* second_arg_name = nullptr, int64_t second_arg = 0)
+        : _tracer(Tracer::installed())
+    {
+        if (_tracer) {
+            _span.name = name;
+            _span.arg_names = {arg_name, second_arg_name};
+            _span.args = {arg, second_arg};
+            _span.begin_ns = _tracer->now();
+        }
+    }
+    ~TraceSpan()
+    {
+        if (_tracer) {
+            _span.end_ns = _tracer->now();
+            _tracer->record(_span);
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+  private:
+    Tracer* _tracer;
+    Tracer::Span _span;
+};
+
+#endif
@@ -0,0 +1,256 @@
+#include "VoiceKernels.h"
+
+#include <initializer_list>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define VOICE_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+using Position = Phase::Position;
+
+template <typename Gain>
+static Position render_linear_scalar(float* out, size_t frames, const float* data,
+                                     Position position, Position rate, Gain gain)
+{
+    for (; frames; --frames, out += Gain::channels) {
+        const auto whole = Phase::whole(position);
+        const float t = Phase::fraction(position);
+        float v0 = data[whole];
+        float v1 = data[whole + 1];
+        gain.add(out, v0 + t * (v1 - v0));
+        position += rate;
+    }
+    return position;
+}
+
+template <typename Gain>
+static Position render_nearest(float* out, size_t frames, const float* data, Position position,
+                               Position rate, Gain gain)
+{
+    for (; frames; --frames, out += Gain::channels) {
+        gain.add(out, data[Phase::whole(position)]);
+        position += rate;
+    }
+    return position;
+}
+
+// Cubic and sinc interpolation: a dot product of the frames around the position with the
+// weights for its phase
+template <Interpolation Mode, typename Gain>
+static Position render_filtered(float* out, size_t frames, const float* data, Position position,
+                                Position rate, Gain gain)
+{
+    constexpr auto taps = interpolation_taps(Mode);
+    constexpr size_t tap_count = taps.before + taps.after + 1;
+    constexpr unsigned phase_shift = 32 - 8;
+    static_assert(interpolation_phases == 1 << 8, "phase_shift picks the table's phase");
+    const float* table = interpolation_table(Mode);
+
+    for (; frames; --frames, out += Gain::channels) {
+        const auto whole = Phase::whole(position);
+        const auto phase = static_cast<uint32_t>(position) >> phase_shift;
+        const float* weights = table + phase * tap_count;
+        const float* frame = data + whole - taps.before;
+
+        float sum = 0;
+        for (size_t k = 0; k < tap_count; ++k) {
+            sum += weights[k] * frame[k];
+        }
+        gain.add(out, sum);
+        position += rate;
+    }
+    return position;
+}
+
+#ifdef VOICE_KERNELS_X86
+
+// Adding a block of interpolated frames to the output. The stereo versions scale the block by
+// each side's gain and interleave the two on the way out.
+__attribute__((target("sse2"))) static void add_block_sse2(float* out, __m128 v, MonoGain gain)
+{
+    v = _mm_mul_ps(v, _mm_set1_ps(gain.volume));
+    _mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(out), v));
+}
+
+__attribute__((target("sse2"))) static void add_block_sse2(float* out, __m128 v, StereoGain gain)
+{
+    __m128 left = _mm_mul_ps(v, _mm_set1_ps(gain.left));
+    __m128 right = _mm_mul_ps(v, _mm_set1_ps(gain.right));
+    _mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(out), _mm_unpacklo_ps(left, right)));
+    _mm_storeu_ps(out + 4, _mm_add_ps(_mm_loadu_ps(out + 4), _mm_unpackhi_ps(left, right)));
+}
+
+__attribute__((target("avx2"))) static void add_block_avx2(float* out, __m256 v, MonoGain gain)
+{
+    v = _mm256_mul_ps(v, _mm256_set1_ps(gain.volume));
+    _mm256_storeu_ps(out, _mm256_add_ps(_mm256_loadu_ps(out), v));
+}
+
+__attribute__((target("avx2"))) static void add_block_avx2(float* out, __m256 v, StereoGain gain)
+{
+    __m256 left = _mm256_mul_ps(v, _mm256_set1_ps(gain.left));
+    __m256 right = _mm256_mul_ps(v, _mm256_set1_ps(gain.right));
+    // Frames 0, 1, 4, 5 and 2, 3, 6, 7, interleaved within each 128 bit half
+    __m256 low = _mm256_unpacklo_ps(left, right);
+    __m256 high = _mm256_unpackhi_ps(left, right);
+    _mm256_storeu_ps(out, _mm256_add_ps(_mm256_loadu_ps(out),
+                                        _mm256_permute2f128_ps(low, high, 0x20)));
+    _mm256_storeu_ps(out + 8, _mm256_add_ps(_mm256_loadu_ps(out + 8),
+                                            _mm256_permute2f128_ps(low, high, 0x31)));
+}
+
+// The whole frames and the fractions of a block of 64 bit positions, from the positions' top
+// and bottom halves. The fraction keeps its top 24 bits, as Phase::fraction() does.
+__attribute__((target("sse2"))) static void split_positions_sse2(__m128i low, __m128i high,
+                                                                   __m128i& whole, __m128& t)
+{
+    low = _mm_shuffle_epi32(low, _MM_SHUFFLE(3, 1, 2, 0));
+    high = _mm_shuffle_epi32(high, _MM_SHUFFLE(3, 1, 2, 0));
+    whole = _mm_unpackhi_epi64(low, high);
+    t = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(_mm_unpacklo_epi64(low, high), 8)),
+                   _mm_set1_ps(1.0f / 16777216.0f));
+}
+
+template <typename Gain>
+__attribute__((target("sse2"))) static Position render_linear_sse2(float* out, size_t frames,
+                                                                    const float* data,
+                                                                    Position position,
+                                                                    Position rate, Gain gain)
+{
+    // Lanes 0 and 1, and 2 and 3, ahead of the block's position
+    const __m128i lanes_low = _mm_set_epi64x(static_cast<long long>(rate), 0);
+    const __m128i lanes_high = _mm_set_epi64x(static_cast<long long>(rate * 3),
+                                              static_cast<long long>(rate * 2));
+    const Position block_rate = rate * 4;
+
+    alignas(16) int whole[4];
+    for (; frames >= 4; frames -= 4, out += 4 * Gain::channels) {
+        const __m128i base = _mm_set1_epi64x(static_cast<long long>(position));
+        __m128i whole_pos;
+        __m128 t;
+        split_positions_sse2(_mm_add_epi64(base, lanes_low), _mm_add_epi64(base, lanes_high),
+                             whole_pos, t);
+        _mm_store_si128(reinterpret_cast<__m128i*>(whole), whole_pos);
+
+        __m128 v0 = _mm_setr_ps(data[whole[0]], data[whole[1]], data[whole[2]], data[whole[3]]);
+        __m128 v1 = _mm_setr_ps(data[whole[0] + 1], data[whole[1] + 1], data[whole[2] + 1],
+                                data[whole[3] + 1]);
+        add_block_sse2(out, _mm_add_ps(v0, _mm_mul_ps(t, _mm_sub_ps(v1, v0))), gain);
+        position += block_rate;
+    }
+    return render_linear_scalar(out, frames, data, position, rate, gain);
+}
+
+__attribute__((target("avx2"))) static void split_positions_avx2(__m256i low, __m256i high,
+                                                                   __m256i& whole, __m256& t)
+{
+    // Bottom halves to the low 128 bits, top halves to the high
+    const __m256i halves = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    low = _mm256_permutevar8x32_epi32(low, halves);
+    high = _mm256_permutevar8x32_epi32(high, halves);
+    whole = _mm256_permute2x128_si256(low, high, 0x31);
+    t = _mm256_mul_ps(
+        _mm256_cvtepi32_ps(_mm256_srli_epi32(_mm256_permute2x128_si256(low, high, 0x20), 8)),
+        _mm256_set1_ps(1.0f / 16777216.0f));
+}
+
+template <typename Gain>
+__attribute__((target("avx2"))) static Position render_linear_avx2(float* out, size_t frames,
+                                                                    const float* data,
+                                                                    Position position,
+                                                                    Position rate, Gain gain)
+{
+    // Lanes 0 to 3, and 4 to 7, ahead of the block's position
+    const __m256i lanes_low = _mm256_setr_epi64x(0, static_cast<long long>(rate),
+                                                 static_cast<long long>(rate * 2),
+                                                 static_cast<long long>(rate * 3));
+    const __m256i lanes_high = _mm256_add_epi64(
+        lanes_low, _mm256_set1_epi64x(static_cast<long long>(rate * 4)));
+    const Position block_rate = rate * 8;
+
+    for (; frames >= 8; frames -= 8, out += 8 * Gain::channels) {
+        const __m256i base = _mm256_set1_epi64x(static_cast<long long>(position));
+        __m256i whole;
+        __m256 t;
+        split_positions_avx2(_mm256_add_epi64(base, lanes_low),
+                             _mm256_add_epi64(base, lanes_high), whole, t);
+        __m256 v0 = _mm256_i32gather_ps(data, whole, sizeof(float));
+        __m256 v1 = _mm256_i32gather_ps(data + 1, whole, sizeof(float));
+        add_block_avx2(out, _mm256_add_ps(v0, _mm256_mul_ps(t, _mm256_sub_ps(v1, v0))), gain);
+        position += block_rate;
+    }
+    // The tail runs as SSE code, which stalls while the upper halves of the registers are dirty
+    _mm256_zeroupper();
+    return render_linear_scalar(out, frames, data, position, rate, gain);
+}
+
+#endif
+
+bool is_supported(VoiceKernelIsa isa)
+{
+    switch (isa) {
+    case VoiceKernelIsa::scalar:
+        return true;
+#ifdef VOICE_KERNELS_X86
+    case VoiceKernelIsa::sse2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse2");
+    case VoiceKernelIsa::avx2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#endif
+    default:
+        return false;
+    }
+}
+
+template <typename Gain> VoiceKernel<Gain> voice_kernel(VoiceKernelIsa isa)
+{
+    switch (isa) {
+#ifdef VOICE_KERNELS_X86
+    case VoiceKernelIsa::sse2:
+        return render_linear_sse2<Gain>;
+    case VoiceKernelIsa::avx2:
+        return render_linear_avx2<Gain>;
+#endif
+    default:
+        return render_linear_scalar<Gain>;
+    }
+}
+
+template <typename Gain> VoiceKernel<Gain> voice_kernel()
+{
+    static const VoiceKernel<Gain> best = [] {
+        for (auto isa : {VoiceKernelIsa::avx2, VoiceKernelIsa::sse2}) {
+            if (is_supported(isa)) {
+                return voice_kernel<Gain>(isa);
+            }
+        }
+        return voice_kernel<Gain>(VoiceKernelIsa::scalar);
+    }();
+    return best;
+}
+
+template <typename Gain> VoiceKernel<Gain> voice_kernel(Interpolation interpolation)
+{
+    switch (interpolation) {
+    case Interpolation::nearest:
+        return render_nearest<Gain>;
+    case Interpolation::cubic:
+        return render_filtered<Interpolation::cubic, Gain>;
+    case Interpolation::sinc8:
+        return render_filtered<Interpolation::sinc8, Gain>;
+    case Interpolation::sinc16:
+        return render_filtered<Interpolation::sinc16, Gain>;
+    default:
+        return voice_kernel<Gain>();
+    }
+}
+
+template VoiceKernel<MonoGain> voice_kernel<MonoGain>(VoiceKernelIsa);
+template VoiceKernel<MonoGain> voice_kernel<MonoGain>();
+template VoiceKernel<MonoGain> voice_kernel<MonoGain>(Interpolation);
+template VoiceKernel<StereoGain> voice_kernel<StereoGain>(VoiceKernelIsa);
+template VoiceKernel<StereoGain> voice_kernel<StereoGain>();
+template VoiceKernel<StereoGain> voice_kernel<StereoGain>(Interpolation);
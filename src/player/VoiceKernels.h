@@ -0,0 +1,55 @@
+#ifndef _PLAYER_VOICE_KERNELS_H_
+#define _PLAYER_VOICE_KERNELS_H_
+
+#include "Interpolation.h"
+#include "Phase.h"
+
+#include <cstddef>
+
+// How a voice lands in the output. MonoGain adds each frame scaled by `volume`; StereoGain
+// adds it to an interleaved left/right pair, scaled by each side's gain.
+struct MonoGain {
+    static constexpr size_t channels = 1;
+    float volume;
+    void add(float* out, float v) const { out[0] += v * volume; }
+};
+
+struct StereoGain {
+    static constexpr size_t channels = 2;
+    float left;
+    float right;
+    void add(float* out, float v) const
+    {
+        out[0] += v * left;
+        out[1] += v * right;
+    }
+};
+
+// A voice kernel mixes `frames` interpolated frames of `data`, scaled by `gain`, into `out`,
+// starting at the Phase `position` and advancing by `rate` per frame. It returns the position
+// following the last frame mixed. `out` holds Gain::channels floats per frame.
+//
+// Kernels do no loop handling: the caller guarantees every frame of the span reads within
+// `data`, i.e. that all of the interpolation_taps() around each position lie inside the sample.
+//
+// Linear interpolation has vectorised kernels, picked by VoiceKernelIsa. Positions are
+// integers, so every kernel visits exactly the same ones; the interpolated frames agree with the
+// scalar reference to within voice_kernel_tolerance, allowing for the compiler arranging the
+// float arithmetic differently.
+template <typename Gain>
+using VoiceKernel = Phase::Position (*)(float* out, size_t frames, const float* data,
+                                        Phase::Position position, Phase::Position rate, Gain gain);
+
+enum class VoiceKernelIsa { scalar, sse2, avx2 };
+
+constexpr float voice_kernel_tolerance = 5.0e-4f;
+
+extern bool is_supported(VoiceKernelIsa isa);
+// A linear interpolation kernel
+template <typename Gain> VoiceKernel<Gain> voice_kernel(VoiceKernelIsa isa);
+// The fastest linear kernel supported by the running CPU, detected once on first use.
+template <typename Gain> VoiceKernel<Gain> voice_kernel();
+// The fastest kernel for `interpolation`
+template <typename Gain> VoiceKernel<Gain> voice_kernel(Interpolation interpolation);
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef _PLAYER_VOICE_SET_H_
+#define _PLAYER_VOICE_SET_H_
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// A bitmask of voice indices. Walking it costs one step per 64 voices plus one per member, so
+// a mixer with a handful of active voices out of many pays only for the active ones.
+//
+// Members can be inserted and erased from several threads at once, as happens when voices
+// sharing a word are mixed on different worker threads.
+class VoiceSet {
+  public:
+    explicit VoiceSet(size_t voice_count = 0) : _words((voice_count + 63) / 64) {}
+
+    void insert(size_t voice)
+    {
+        _words[voice / 64].fetch_or(bit(voice), std::memory_order_relaxed);
+    }
+    void erase(size_t voice)
+    {
+        _words[voice / 64].fetch_and(~bit(voice), std::memory_order_relaxed);
+    }
+    bool contains(size_t voice) const { return word(voice / 64) & bit(voice); }
+
+    size_t size() const
+    {
+        size_t count = 0;
+        for (size_t w = 0; w < _words.size(); ++w) {
+            count += static_cast<size_t>(__builtin_popcountll(word(w)));
+        }
+        return count;
+    }
+
+    // Calls f with each member in ascending order. Members may be erased from within f.
+    template <typename F> void for_each(F&& f) const
+    {
+        for (size_t w = 0; w < _words.size(); ++w) {
+            for (auto bits = word(w); bits; bits &= bits - 1) {
+                f(w * 64 + static_cast<size_t>(__builtin_ctzll(bits)));
+            }
+        }
+    }
+
+  private:
+    static uint64_t bit(size_t voice) { return uint64_t{1} << (voice % 64); }
+    uint64_t word(size_t w) const { return _words[w].load(std::memory_order_relaxed); }
+
+    std::vector<std::atomic<uint64_t>> _words;
+};
+
+#endif
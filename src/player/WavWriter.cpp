@@ -0,0 +1,71 @@
+#include "WavWriter.h"
+
+#include <algorithm>
+#include <cmath>
+
+static void put_u16(char* out, uint16_t value)
+{
+    out[0] = static_cast<char>(value & 0xFF);
+    out[1] = static_cast<char>(value >> 8);
+}
+
+static void put_u32(char* out, uint32_t value)
+{
+    put_u16(out, static_cast<uint16_t>(value & 0xFFFF));
+    put_u16(out + 2, static_cast<uint16_t>(value >> 16));
+}
+
+WavWriter::WavWriter(std::ostream& os, unsigned int sample_rate, unsigned int channels)
+    : _os(os), _start(os.tellp()), _sample_rate(sample_rate), _channels(channels)
+{
+    write_header(0);
+}
+
+WavWriter::~WavWriter()
+{
+    if (!_finished) {
+        finish();
+    }
+}
+
+void WavWriter::write(const float* frames, size_t frame_count)
+{
+    const size_t samples = frame_count * _channels;
+    _pcm.resize(samples * 2);
+    for (size_t i = 0; i < samples; ++i) {
+        const float clamped = std::clamp(frames[i], -1.0f, 1.0f);
+        const auto value = static_cast<int16_t>(std::lrint(clamped * 32767.0f));
+        put_u16(&_pcm[i * 2], static_cast<uint16_t>(value));
+    }
+    _os.write(_pcm.data(), static_cast<std::streamsize>(_pcm.size()));
+    _frames_written += frame_count;
+}
+
+void WavWriter::finish()
+{
+    const auto end = _os.tellp();
+    _os.seekp(_start);
+    write_header(static_cast<uint32_t>(_frames_written * _channels * 2));
+    _os.seekp(end);
+    _os.flush();
+    _finished = true;
+}
+
+void WavWriter::write_header(uint32_t data_bytes)
+{
+    const auto block_align = static_cast<uint16_t>(_channels * 2);
+    char header[44];
+    std::copy_n("RIFF", 4, header);
+    put_u32(header + 4, 36 + data_bytes);
+    std::copy_n("WAVEfmt ", 8, header + 8);
+    put_u32(header + 16, 16);
+    put_u16(header + 20, 1); // PCM
+    put_u16(header + 22, static_cast<uint16_t>(_channels));
+    put_u32(header + 24, _sample_rate);
+    put_u32(header + 28, _sample_rate * block_align);
+    put_u16(header + 32, block_align);
+    put_u16(header + 34, 16);
+    std::copy_n("data", 4, header + 36);
+    put_u32(header + 40, data_bytes);
+    _os.write(header, sizeof header);
+}
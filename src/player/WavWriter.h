@@ -0,0 +1,39 @@
+#ifndef _PLAYER_WAV_WRITER_H_
+#define _PLAYER_WAV_WRITER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Writes interleaved float frames to a stream as a 16 bit PCM WAV file. The header goes out
+// first with empty sizes, patched in by finish(), so the stream must be seekable.
+class WavWriter {
+  public:
+    WavWriter(std::ostream& os, unsigned int sample_rate, unsigned int channels);
+    // Finishes the file if finish() hasn't been called
+    ~WavWriter();
+
+    WavWriter(const WavWriter&) = delete;
+    WavWriter& operator=(const WavWriter&) = delete;
+
+    // Samples are clamped to [-1, 1]
+    void write(const float* frames, size_t frame_count);
+    void finish();
+
+    size_t frames_written() const { return _frames_written; }
+
+  private:
+    void write_header(uint32_t data_bytes);
+
+  private:
+    std::ostream& _os;
+    std::streampos _start;
+    unsigned int _sample_rate;
+    unsigned int _channels;
+    size_t _frames_written = 0;
+    bool _finished = false;
+    std::vector<char> _pcm;
+};
+
+#endif
@@ -0,0 +1,68 @@
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool(size_t thread_count)
+{
+    for (size_t i = 1; i < thread_count; ++i) {
+        _threads.emplace_back([this] { work(); });
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _wake.notify_all();
+    for (auto& thread : _threads) {
+        thread.join();
+    }
+}
+
+void WorkerPool::dispatch(size_t task_count, TaskFn fn, void* context)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _fn = fn;
+        _context = context;
+        _task_count = task_count;
+        _next_task.store(0, std::memory_order_relaxed);
+        _busy = _threads.size();
+        ++_generation;
+    }
+    _wake.notify_all();
+
+    drain();
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _finished.wait(lock, [this] { return _busy == 0; });
+}
+
+void WorkerPool::drain()
+{
+    for (auto task = _next_task.fetch_add(1, std::memory_order_relaxed); task < _task_count;
+         task = _next_task.fetch_add(1, std::memory_order_relaxed)) {
+        _fn(_context, task);
+    }
+}
+
+void WorkerPool::work()
+{
+    size_t seen_generation = 0;
+    std::unique_lock<std::mutex> lock(_mutex);
+    for (;;) {
+        _wake.wait(lock, [&] { return _stopping || _generation != seen_generation; });
+        if (_stopping) {
+            return;
+        }
+        seen_generation = _generation;
+
+        lock.unlock();
+        drain();
+        lock.lock();
+
+        if (--_busy == 0) {
+            _finished.notify_one();
+        }
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef _PLAYER_WORKER_POOL_H_
+#define _PLAYER_WORKER_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fork/join pool. run() hands out tasks to the pool's threads, works on them from the calling
+// thread as well, and returns once every task has finished. A pool of one thread is simply the
+// calling thread.
+class WorkerPool {
+  public:
+    explicit WorkerPool(size_t thread_count);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    size_t thread_count() const { return _threads.size() + 1; }
+
+    // Calls task(i) once for every i in [0, task_count)
+    template <typename F> void run(size_t task_count, F& task)
+    {
+        dispatch(
+            task_count, [](void* t, size_t i) { (*static_cast<F*>(t))(i); }, &task);
+    }
+
+  private:
+    using TaskFn = void (*)(void* context, size_t task);
+
+    void dispatch(size_t task_count, TaskFn fn, void* context);
+    void drain();
+    void work();
+
+  private:
+    std::vector<std::thread> _threads;
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _finished;
+    size_t _generation = 0;
+    size_t _busy = 0;
+    bool _stopping = false;
+
+    TaskFn _fn = nullptr;
+    void* _context = nullptr;
+    size_t _task_count = 0;
+    std::atomic<size_t> _next_task{0};
+};
+
+#endif
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include <player/Mixer.h>
+#include <player/Module.h>
+#include <player/PerfCounters.h>
+#include <player/Player.h>
+#include <player/Tracer.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Every global operator new in the test binary goes through here, so a test can count the
+// allocations made by the code it runs
+static std::atomic<size_t> allocation_count{0};
+
+void* operator new(size_t size)
+{
+    ++allocation_count;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+
+template <typename F> static size_t allocations_during(F&& f)
+{
+    const size_t before = allocation_count.load();
+    f();
+    return allocation_count.load() - before;
+}
+
+TEST(Allocations, AreCounted)
+{
+    EXPECT_EQ(allocations_during([] {
+                  auto one = std::make_unique<int>(1);
+                  std::vector<int> many(16);
+              }),
+              2UL);
+}
+
+TEST(Allocations, PlayerRendersWithoutAllocating)
+{
+    auto mod = std::make_shared<Module>();
+    mod->initial_speed = 3;
+    mod->initial_tempo = 125;
+    mod->patterns.resize(1, Pattern(4));
+    mod->patternOrder = {0, 255};
+    mod->samples.emplace_back(Sample{{0.5f, 1.0f, 0.5f, 1.0f, -0.5f, 0.25f}, 8363});
+    // Every channel raises every kind of event: notes, frequency and volume changes and sample
+    // offsets, with a tempo change on the way
+    std::string row;
+    for (size_t c = 0; c < 32; ++c) {
+        row += c == 0 ? "C-5 01 32 T40 " : "C-5 01 32 O01 ";
+    }
+    std::string pattern;
+    for (size_t r = 0; r < 4; ++r) {
+        pattern += row + "\n";
+    }
+    ASSERT_TRUE(parse_pattern(pattern, mod->patterns[0]));
+
+    Player player(mod);
+    std::vector<float> buffer(2 * 4096);
+    const auto allocations = allocations_during([&] {
+        for (int i = 0; i < 8; ++i) {
+            player.render_stereo_audio(&buffer[0], 4096);
+            player.render_audio(&buffer[0], 512);
+        }
+    });
+    EXPECT_EQ(allocations, 0UL);
+
+    PerfCounters counters;
+    player.set_perf_counters(&counters);
+    EXPECT_EQ(allocations_during([&] { player.render_stereo_audio(&buffer[0], 4096); }), 0UL);
+    EXPECT_GT(counters.snapshot().ticks, 0UL);
+
+    // The tracer allocates its rings up front, and each thread claims one with its first span
+    std::ostringstream trace;
+    Tracer tracer(trace);
+    tracer.install();
+    player.render_stereo_audio(&buffer[0], 16);
+    EXPECT_EQ(allocations_during([&] { player.render_stereo_audio(&buffer[0], 4096); }), 0UL);
+    tracer.uninstall();
+}
+
+TEST(Allocations, MixersRenderAnyBlockWithoutAllocating)
+{
+    Sample sample({1.0f, 0.5f, 0.25f, 0}, 1, {Sample::LoopParams::Type::forward_looping, 1});
+    sample.add_pcm16();
+
+    auto check = [&](auto& mixer, const char* name) {
+        mixer.set_block_frames(700);
+        for (size_t c = 0; c < 40; ++c) {
+            mixer.channel(c).play(&sample);
+        }
+        std::vector<float> buffer(2 * 2000);
+        const auto allocations = allocations_during([&] {
+            mixer.render(&buffer[0], 2000);
+            mixer.render_stereo(&buffer[0], 2000);
+        });
+        EXPECT_EQ(allocations, 0UL) << name;
+    };
+
+    Mixer inline_mixer(44100, 40);
+    check(inline_mixer, "inline");
+    Mixer worker_mixer(44100, 40);
+    worker_mixer.set_thread_count(2);
+    check(worker_mixer, "workers");
+    FixedPointMixer fixed_point_mixer(44100, 40);
+    check(fixed_point_mixer, "fixed point");
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+
+#include <player/BatchRender.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+class BatchRenderTest : public ::testing::Test {
+  protected:
+    void SetUp() override
+    {
+        dir = fs::temp_directory_path() / ("batch_render_" + std::to_string(::getpid()));
+        fs::create_directories(dir);
+    }
+    void TearDown() override { fs::remove_all(dir); }
+
+    // The smallest S3M the loader plays: one order of one empty 64 row pattern, at speed 1
+    std::string write_s3m(const std::string& name)
+    {
+        std::vector<uint8_t> file(0x80 + 2 + 64);
+        file[0x20] = 2; // orders
+        file[0x24] = 1; // patterns
+        file[0x31] = 1; // speed
+        file[0x32] = 125; // tempo
+        file[0x60] = 0;
+        file[0x61] = 255;
+        file[0x62] = 0x80 / 16; // pattern parapointer
+        file[0x80] = 64; // packed pattern length, then one end of row byte per row
+
+        const auto path = (dir / name).string();
+        std::ofstream(path, std::ios::binary)
+            .write(reinterpret_cast<const char*>(file.data()),
+                   static_cast<std::streamsize>(file.size()));
+        return path;
+    }
+
+    std::string output(const std::string& name) const { return (dir / name).string(); }
+
+    fs::path dir;
+    const size_t song_frames = 64 * 882;
+};
+
+TEST_F(BatchRenderTest, RendersEveryModuleToItsOwnFile)
+{
+    std::vector<BatchJob> jobs;
+    for (int i = 0; i < 5; ++i) {
+        const auto name = std::to_string(i);
+        jobs.push_back({write_s3m(name + ".s3m"), output(name + ".wav")});
+    }
+    const auto results = render_batch(jobs, 2);
+    ASSERT_EQ(results.size(), jobs.size());
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        EXPECT_EQ(results[i].module_path, jobs[i].module_path);
+        EXPECT_TRUE(results[i].ok()) << results[i].error;
+        EXPECT_EQ(results[i].frames, song_frames);
+        EXPECT_EQ(results[i].sample_rate, 44100U);
+        EXPECT_EQ(fs::file_size(jobs[i].output_path), 44 + 4 * song_frames);
+    }
+}
+
+TEST_F(BatchRenderTest, ReportsModulesThatDontRender)
+{
+    std::ofstream(output("notes.txt")) << "not a module";
+    const std::vector<BatchJob> jobs = {{output("missing.s3m"), output("missing.wav")},
+                                        {output("notes.txt"), output("notes.wav")},
+                                        {write_s3m("good.s3m"), output("good.wav")}};
+    const auto results = render_batch(jobs, 3);
+    ASSERT_EQ(results.size(), 3UL);
+    EXPECT_FALSE(results[0].ok());
+    EXPECT_FALSE(results[1].ok());
+    EXPECT_TRUE(results[2].ok()) << results[2].error;
+    for (const auto& result : results) {
+        EXPECT_GT(result.seconds, 0.0) << result.module_path;
+    }
+    EXPECT_FALSE(fs::exists(output("missing.wav")));
+    EXPECT_FALSE(fs::exists(output("notes.wav")));
+}
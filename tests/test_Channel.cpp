@@ -167,4 +167,114 @@ TEST(ChannelEventsInterpretation, CanSetNoteOn)
     EXPECT_EQ(channel.frequency(), 8363.0f);
     EXPECT_EQ(channel.sample(), &sample);
     EXPECT_TRUE(channel.is_active());
-}
\ No newline at end of file
+}
+TEST(Channel, CanMixIntoExistingOutput)
+{
+    std::vector<float> expected{1.5f, 0.5f, 1.5f, 0.5f};
+    std::vector<float> buffer{0.5f, 0.5f, 0.5f, 0.5f};
+
+    Sample sample({1.0f, 0}, 1);
+    Channel c;
+    c.play(&sample);
+    c.mix(&buffer[0], buffer.size(), 1);
+
+    EXPECT_EQ(buffer, expected);
+}
+
+TEST(Channel, IdleChannelLeavesMixUntouched)
+{
+    std::vector<float> expected{1.0f, 2.0f, 3.0f, 4.0f};
+    std::vector<float> buffer(expected);
+
+    Channel c;
+    c.mix(&buffer[0], buffer.size(), 1);
+
+    EXPECT_EQ(buffer, expected);
+}
+
+TEST(Channel, PanningSetsStereoGains)
+{
+    Channel c;
+    EXPECT_EQ(c.left_gain(), 1.0f);
+    EXPECT_EQ(c.right_gain(), 1.0f);
+
+    c.set_panning(0);
+    EXPECT_EQ(c.left_gain(), 1.0f);
+    EXPECT_EQ(c.right_gain(), 0);
+
+    c.set_panning(0.75f);
+    EXPECT_EQ(c.left_gain(), 0.5f);
+    EXPECT_EQ(c.right_gain(), 1.0f);
+}
+
+TEST(Channel, CanMixInterleavedStereo)
+{
+    std::vector<float> expected{1.0f, 0.5f, 0.75f, 0.5f};
+    std::vector<float> buffer{0.5f, 0.5f, 0.5f, 0.5f};
+
+    Sample sample({1.0f, 0.5f}, 1);
+    Channel c;
+    c.set_panning(0);
+    c.set_volume(0.5f);
+    c.play(&sample);
+    c.mix_stereo(&buffer[0], 2, 1);
+
+    EXPECT_EQ(buffer, expected);
+}
+
+TEST(Channel, ShortLoopsMatchTheLoopUnrolled)
+{
+    std::vector<float> data{0.1f, -0.4f, 0.9f, 0.3f, -0.7f, 0.2f, 0.5f, -0.2f, 0.8f, -0.6f, 0.4f};
+    Sample sample(data.begin(), data.end(), 1, {Sample::LoopParams::Type::forward_looping, 8});
+    // The same sound as a one shot, with the three frame loop written out
+    std::vector<float> unrolled_data(data);
+    while (unrolled_data.size() < 160) {
+        unrolled_data.push_back(unrolled_data[unrolled_data.size() - 3]);
+    }
+    Sample unrolled(unrolled_data.begin(), unrolled_data.end(), 1);
+
+    for (auto interpolation : {Interpolation::nearest, Interpolation::linear,
+                               Interpolation::cubic, Interpolation::sinc16}) {
+        Channel c;
+        // A rate exact in binary keeps the positions identical, so nearest can't round apart
+        c.set_frequency(0.375f);
+        c.play(&sample);
+        std::vector<float> buffer(300);
+        // In uneven pieces, to cross the loop seam on either side of a buffer boundary
+        for (size_t offset = 0, length = 1; offset < buffer.size(); offset += length++) {
+            c.mix(&buffer[offset], std::min(length, buffer.size() - offset), 1, interpolation);
+        }
+
+        for (size_t i = 0; i < buffer.size(); ++i) {
+            const float position = 0.375f * static_cast<float>(i);
+            ASSERT_NEAR(buffer[i], interpolate(unrolled, position, interpolation), 1.0e-5f)
+                << "interpolation " << static_cast<int>(interpolation) << " frame " << i;
+        }
+    }
+}
+
+TEST(Channel, PitchStaysExactFarIntoLongSamples)
+{
+    // A float position this far in only resolves eighths of a frame, enough to turn a third of a
+    // frame per step into three eighths
+    const size_t start = size_t{1} << 20;
+    std::vector<float> data(start + 64);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<float>(i % 7);
+    }
+    Sample sample(data.begin(), data.end(), 1);
+
+    Channel c;
+    c.play(&sample);
+    c.set_sample_index(static_cast<int>(start));
+    c.set_frequency(1.0f / 3.0f);
+
+    std::vector<float> buffer(96);
+    c.mix(&buffer[0], buffer.size(), 1, Interpolation::nearest);
+
+    const double rate = static_cast<double>(Phase::rate(1.0f / 3.0f, 1)) / Phase::one;
+    for (size_t i = 0; i < buffer.size(); ++i) {
+        const auto frame = start + static_cast<size_t>(static_cast<double>(i) * rate);
+        ASSERT_EQ(buffer[i], data[frame]) << "frame " << i;
+    }
+}
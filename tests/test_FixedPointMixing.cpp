@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include <player/Mixer.h>
+#include <player/Sample.h>
+
+#include <cmath>
+#include <vector>
+
+static std::vector<float> make_sine(size_t length, float cycles)
+{
+    std::vector<float> data(length);
+    for (size_t i = 0; i < length; ++i) {
+        auto phase = static_cast<float>(i) / static_cast<float>(length);
+        data[i] = 0.5f * std::sin(6.2831853f * cycles * phase);
+    }
+    return data;
+}
+
+TEST(FixedPointMixing, SamplesKeepA16BitCopy)
+{
+    Sample sample({0, 1.0f, -1.0f, 0.5f, 2.0f}, 1);
+    sample.add_pcm16();
+    const int16_t* pcm16 = sample.pcm16();
+
+    EXPECT_EQ(pcm16[0], 0);
+    EXPECT_EQ(pcm16[1], 32767);
+    EXPECT_EQ(pcm16[2], -32767);
+    EXPECT_EQ(pcm16[3], 16384);
+    // Out of range frames are clamped
+    EXPECT_EQ(pcm16[4], 32767);
+}
+
+TEST(FixedPointMixing, OutputIsExactlyPredictable)
+{
+    Sample sample({0, 1.0f}, 1, {Sample::LoopParams::Type::non_looping});
+    sample.add_pcm16();
+    FixedPointMixer mixer(2, 1);
+    mixer.channel(0).play(&sample);
+
+    std::vector<float> buffer(5);
+    mixer.render(&buffer[0], buffer.size());
+
+    // Halfway between 0 and 32767 is 16383, which lands as 16383 << 8 of 1 << 23. The last
+    // frame interpolates towards the silence after the end.
+    const float full_scale = 8388608.0f;
+    std::vector<float> expected{0, 4194048.0f / full_scale, 8388352.0f / full_scale,
+                                4194048.0f / full_scale, 0};
+    EXPECT_EQ(buffer, expected);
+    EXPECT_FALSE(mixer.channel(0).is_active());
+}
+
+TEST(FixedPointMixing, TracksFloatMixingClosely)
+{
+    const auto data = make_sine(4096, 37);
+    Sample sample(data.begin(), data.end(), 8363);
+    sample.add_pcm16();
+
+    Mixer float_mixer(44100, 1);
+    FixedPointMixer fixed_mixer(44100, 1);
+    float_mixer.channel(0).set_frequency(8363.0f * 1.37f);
+    float_mixer.channel(0).set_volume(0.75f);
+    float_mixer.channel(0).play(&sample);
+    fixed_mixer.channel(0).set_frequency(8363.0f * 1.37f);
+    fixed_mixer.channel(0).set_volume(0.75f);
+    fixed_mixer.channel(0).play(&sample);
+
+    std::vector<float> expected(2048);
+    std::vector<float> buffer(2048);
+    float_mixer.render(&expected[0], expected.size());
+    fixed_mixer.render(&buffer[0], buffer.size());
+
+    for (size_t i = 0; i < buffer.size(); ++i) {
+        ASSERT_NEAR(buffer[i], expected[i], 1.0e-3f) << "frame " << i;
+    }
+    EXPECT_NEAR(fixed_mixer.channel(0).sample_index(), float_mixer.channel(0).sample_index(),
+                1.0e-2f);
+}
+
+TEST(FixedPointMixing, SaturatesAtFullScale)
+{
+    Sample sample({1.0f, -1.0f}, 1);
+    sample.add_pcm16();
+    FixedPointMixer mixer(1, 4);
+    for (size_t c = 0; c < 4; ++c) {
+        mixer.channel(c).play(&sample);
+    }
+
+    std::vector<float> buffer(2);
+    mixer.render(&buffer[0], buffer.size());
+
+    EXPECT_EQ(buffer[0], 8388607.0f / 8388608.0f);
+    EXPECT_EQ(buffer[1], -1.0f);
+}
+
+TEST(FixedPointMixing, WorkerAndStereoMixingMatchInline)
+{
+    const auto data = make_sine(512, 5);
+    Sample sample(data.begin(), data.end(), 8363);
+    sample.add_pcm16();
+
+    auto render = [&](size_t thread_count) {
+        FixedPointMixer mixer(44100, 24);
+        mixer.set_thread_count(thread_count);
+        for (size_t c = 0; c < 24; c += 2) {
+            mixer.channel(c).set_frequency(8363.0f + 500.0f * static_cast<float>(c));
+            mixer.channel(c).set_volume(0.1f);
+            mixer.channel(c).set_panning(static_cast<float>(c) / 24.0f);
+            mixer.channel(c).play(&sample);
+        }
+        std::vector<float> buffer(2000);
+        mixer.render_stereo(&buffer[0], buffer.size() / 2);
+        return buffer;
+    };
+
+    // Integer sums do not depend on the order voices are added in
+    const auto expected = render(0);
+    for (size_t thread_count = 1; thread_count <= 3; ++thread_count) {
+        EXPECT_EQ(render(thread_count), expected) << thread_count << " threads";
+    }
+}
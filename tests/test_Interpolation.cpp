@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include <player/Interpolation.h>
+#include <player/Mixer.h>
+#include <player/Sample.h>
+
+#include <vector>
+
+static const Interpolation all_interpolations[] = {Interpolation::nearest, Interpolation::linear,
+                                                   Interpolation::cubic, Interpolation::sinc8,
+                                                   Interpolation::sinc16};
+
+TEST(Interpolation, EveryModePassesConstantSignalUnchanged)
+{
+    std::vector<float> data(64, 0.5f);
+    Sample sample(data.begin(), data.end(), 1, {Sample::LoopParams::Type::forward_looping, 16});
+
+    for (auto interpolation : all_interpolations) {
+        Channel c;
+        c.play(&sample);
+        c.set_frequency(0.37f);
+
+        // Long enough to cross the loop seam a few times
+        std::vector<float> buffer(512);
+        c.mix(&buffer[0], buffer.size(), 1, interpolation);
+        // Skip the first frames whose taps reach before the start of the sample
+        for (size_t i = 32; i < buffer.size(); ++i) {
+            ASSERT_NEAR(buffer[i], 0.5f, 1.0e-5f)
+                << "interpolation " << static_cast<int>(interpolation) << " frame " << i;
+        }
+    }
+}
+
+TEST(Interpolation, EveryModeHitsFramesExactly)
+{
+    std::vector<float> data{0, 0.25f, -1.0f, 0.5f, 0.75f, -0.5f, 0.125f, 1.0f,
+                            0, 0.25f, -1.0f, 0.5f, 0.75f, -0.5f, 0.125f, 1.0f};
+    Sample sample(data.begin(), data.end(), 1);
+
+    for (auto interpolation : all_interpolations) {
+        for (size_t i = 0; i < data.size(); ++i) {
+            EXPECT_NEAR(interpolate(sample, static_cast<float>(i), interpolation), data[i],
+                        1.0e-6f)
+                << "interpolation " << static_cast<int>(interpolation) << " frame " << i;
+        }
+    }
+}
+
+TEST(Interpolation, NearestHoldsEachFrame)
+{
+    Sample sample({0, 1.0f}, 1, {Sample::LoopParams::Type::non_looping});
+    Channel c;
+    c.play(&sample);
+    c.set_frequency(0.5f);
+
+    std::vector<float> buffer(4);
+    c.mix(&buffer[0], buffer.size(), 1, Interpolation::nearest);
+
+    EXPECT_EQ(buffer, (std::vector<float>{0, 0, 1.0f, 1.0f}));
+}
+
+TEST(Interpolation, MixerAppliesItsInterpolationToEveryVoice)
+{
+    Sample sample({0, 1.0f}, 1, {Sample::LoopParams::Type::non_looping});
+    Mixer mixer(2, 2);
+    mixer.set_interpolation(Interpolation::nearest);
+    mixer.channel(0).play(&sample);
+    mixer.channel(1).play(&sample);
+
+    std::vector<float> buffer(4);
+    mixer.render(&buffer[0], buffer.size());
+
+    EXPECT_EQ(buffer, (std::vector<float>{0, 0, 2.0f, 2.0f}));
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <loader/module.h>
+#include <player/Mixer.h>
+#include <player/Module.h>
+#include <player/Player.h>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+template <typename T> static void put(std::vector<uint8_t>& file, size_t at, T value)
+{
+    std::memcpy(&file[at], &value, sizeof(value));
+}
+
+// One order of one pattern, with nothing in it but a set volume of 32 on `channel`'s first row
+static std::vector<uint8_t> s3m_using_channel(uint8_t channel)
+{
+    std::vector<uint8_t> file(0x80);
+    file[0x20] = 2; // orders
+    file[0x24] = 1; // patterns
+    file[0x31] = 1; // speed
+    file[0x32] = 125; // tempo
+    file[0x60] = 0;
+    file[0x61] = 255;
+    file[0x62] = 0x80 / 16; // pattern parapointer
+
+    const std::vector<uint8_t> row = {static_cast<uint8_t>(channel | 64), 32, 0};
+    file.resize(0x82);
+    put<uint16_t>(file, 0x80, static_cast<uint16_t>(row.size() + 63));
+    file.insert(file.end(), row.begin(), row.end());
+    file.resize(file.size() + 63);
+    return file;
+}
+
+// The same as an IT, whose patterns address 64 channels
+static std::vector<uint8_t> it_using_channel(uint8_t channel)
+{
+    std::vector<uint8_t> file(0xD8);
+    put<uint16_t>(file, 0x20, 2); // orders
+    put<uint16_t>(file, 0x26, 1); // patterns
+    file[0x32] = 1; // speed
+    file[0x33] = 125; // tempo
+    file[0xC0] = 0;
+    file[0xC1] = 255;
+    put<uint32_t>(file, 0xC2, 0xD0); // pattern pointer
+
+    // Channel and mask, the volume, then the end of each row
+    const uint8_t channel_and_mask = static_cast<uint8_t>((channel + 1) | 128);
+    const std::vector<uint8_t> rows = {channel_and_mask, 4, 32, 0, 0, 0, 0};
+    put<uint16_t>(file, 0xD0, static_cast<uint16_t>(rows.size()));
+    put<uint16_t>(file, 0xD2, 4);
+    file.insert(file.end(), rows.begin(), rows.end());
+    return file;
+}
+
+static std::vector<Mixer::Event> first_tick(const std::shared_ptr<Module>& module)
+{
+    Player player(module);
+    EXPECT_EQ(player.channels.size(), module->channel_count());
+    return player.process_tick();
+}
+
+TEST(Loaders, SizeS3MsToTheChannelsTheyUse)
+{
+    const auto file = s3m_using_channel(5);
+    const auto module = load_module(file.data(), file.size(), ModuleFormat::s3m);
+    ASSERT_TRUE(module);
+    EXPECT_EQ(module->channel_count(), 6UL);
+    EXPECT_EQ(module->patterns[0].entry(0, 5).volume_effect,
+              (PatternEntry::Effect{PatternEntry::Command::set_volume, 32}));
+
+    const std::vector<Mixer::Event> volume_to_half{{5, Channel::Event::SetVolume{0.5}}};
+    EXPECT_EQ(first_tick(module), volume_to_half);
+}
+
+TEST(Loaders, PlayEveryChannelAnITAddresses)
+{
+    for (const uint8_t channel : std::vector<uint8_t>{0, 47, 63}) {
+        const auto file = it_using_channel(channel);
+        const auto module = load_module(file.data(), file.size(), ModuleFormat::it);
+        ASSERT_TRUE(module);
+        EXPECT_EQ(module->channel_count(), channel + 1UL);
+        EXPECT_EQ(module->patterns[0].row_count(), 4UL);
+
+        const std::vector<Mixer::Event> volume_to_half{{channel, Channel::Event::SetVolume{0.5}}};
+        EXPECT_EQ(first_tick(module), volume_to_half) << "channel " << int{channel};
+    }
+}
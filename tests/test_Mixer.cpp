@@ -110,4 +110,114 @@ TEST(Mixer, CanProcessMixerEvent)
 
     EXPECT_EQ(mixer.channel(0).frequency(), 8363.0f);
     EXPECT_EQ(mixer.channel(0).sample(), &sample);
-}
\ No newline at end of file
+}
+TEST(Mixer, TracksActiveVoices)
+{
+    Mixer mixer(1, 70);
+    Sample looping({1.0f, 0}, 1);
+    Sample one_shot({1.0f, 0}, 1, {Sample::LoopParams::Type::non_looping});
+
+    EXPECT_EQ(mixer.active_voice_count(), 0UL);
+
+    mixer.channel(3).play(&looping);
+    mixer.channel(69).play(&one_shot);
+    EXPECT_EQ(mixer.active_voice_count(), 2UL);
+
+    mixer.channel(3).stop();
+    EXPECT_EQ(mixer.active_voice_count(), 1UL);
+
+    // The one shot sample ends during this render and drops out of the mix
+    std::vector<float> buffer(4);
+    mixer.render(&buffer[0], buffer.size());
+    EXPECT_EQ(mixer.active_voice_count(), 0UL);
+    EXPECT_EQ(buffer, (std::vector<float>{1.0f, 0, 0, 0}));
+}
+
+TEST(Mixer, WorkerMixingIsIdenticalForAnyThreadCount)
+{
+    std::vector<Sample> samples;
+    for (size_t s = 0; s < 5; ++s) {
+        std::vector<float> data(64);
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = static_cast<float>((i * (s + 3)) % 17) / 17.0f - 0.5f;
+        }
+        samples.emplace_back(data.begin(), data.end(), 1);
+    }
+
+    auto render = [&](size_t thread_count) {
+        Mixer mixer(44100, 40);
+        mixer.set_thread_count(thread_count);
+        for (size_t c = 0; c < 40; c += 3) {
+            mixer.channel(c).set_frequency(11025.0f + 1000.0f * static_cast<float>(c));
+            mixer.channel(c).set_volume(0.3f + 0.01f * static_cast<float>(c));
+            mixer.channel(c).play(&samples[c % samples.size()]);
+        }
+        std::vector<float> buffer(1000);
+        mixer.render(&buffer[0], buffer.size());
+        return buffer;
+    };
+
+    const auto expected = render(1);
+    for (size_t thread_count = 2; thread_count <= 4; ++thread_count) {
+        EXPECT_EQ(render(thread_count), expected) << thread_count << " threads";
+    }
+}
+
+TEST(Mixer, CanRenderStereo)
+{
+    Sample sample({1.0f, 0.5f, 0.25f, 0}, 1);
+    std::vector<float> expected{0.5f, 1.25f, 0.25f, 0.625f, 0.125f, 0.3125f};
+
+    for (size_t thread_count : {0UL, 2UL}) {
+        Mixer mixer(1, 2);
+        mixer.set_thread_count(thread_count);
+        mixer.channel(0).set_panning(1.0f);
+        mixer.channel(0).play(&sample);
+        mixer.channel(1).set_panning(0.25f);
+        mixer.channel(1).set_volume(0.5f);
+        mixer.channel(1).play(&sample);
+
+        std::vector<float> buffer(6);
+        mixer.render_stereo(&buffer[0], 3);
+        EXPECT_EQ(buffer, expected) << thread_count << " threads";
+    }
+}
+
+TEST(Mixer, LongRendersMatchAnyBlockLength)
+{
+    struct TickCounter : public Mixer::TickHandler {
+        void onAttachment(Mixer& audio) override { audio.set_samples_per_tick(5000); }
+        void onTick(Mixer&) override { ++ticks; }
+        size_t ticks = 0;
+    };
+
+    std::vector<float> data(100);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<float>(i % 13) / 13.0f - 0.5f;
+    }
+    Sample sample(data.begin(), data.end(), 1, {Sample::LoopParams::Type::forward_looping, 10});
+
+    auto render = [&](size_t block_frames, size_t thread_count) {
+        Mixer mixer(44100, 3);
+        mixer.set_block_frames(block_frames);
+        mixer.set_thread_count(thread_count);
+        TickCounter counter;
+        mixer.attach_handler(&counter);
+        for (size_t c = 0; c < 3; ++c) {
+            mixer.channel(c).set_frequency(20000.0f + 3000.0f * static_cast<float>(c));
+            mixer.channel(c).set_panning(0.4f * static_cast<float>(c));
+            mixer.channel(c).play(&sample);
+        }
+        // Well past the default block and the tick length
+        std::vector<float> buffer(65536 * 2);
+        mixer.render_stereo(&buffer[0], 65536);
+        EXPECT_EQ(counter.ticks, 14UL) << block_frames << " frame blocks";
+        return buffer;
+    };
+
+    const auto expected = render(Mixer::default_block_frames, 0);
+    for (size_t block_frames : {7UL, 4096UL, 65536UL}) {
+        EXPECT_EQ(render(block_frames, 0), expected) << block_frames << " frame blocks";
+    }
+    EXPECT_EQ(render(7, 2), render(65536, 2));
+}
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <player/ModuleRenderer.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+// The smallest S3M worth hearing: one order of one 64 row pattern at speed 1, playing a single
+// 8 bit sample on its first row
+static std::vector<uint8_t> tiny_s3m()
+{
+    std::vector<uint8_t> file(0xD2);
+    file[0x20] = 2; // orders
+    file[0x22] = 1; // instruments
+    file[0x24] = 1; // patterns
+    file[0x31] = 1; // speed
+    file[0x32] = 125; // tempo
+    file[0x60] = 0;
+    file[0x61] = 255;
+    file[0x62] = 0x70 / 16; // instrument parapointer
+    file[0x64] = 0xD0 / 16; // pattern parapointer
+
+    // The instrument: where its data is, its length, volume and C4 speed, then the data itself
+    file[0x7E] = 0xC0 / 16;
+    file[0x80] = 16;
+    file[0x8C] = 64;
+    file[0x90] = 0xAC; // 8363
+    file[0x91] = 0x20;
+    for (size_t i = 0; i < 16; ++i) {
+        file[0xC0 + i] = static_cast<uint8_t>(i * 16);
+    }
+
+    // The pattern: C-5 with instrument 1 on the first channel, then an end marker for each row
+    const std::vector<uint8_t> pattern = {0x20, 0x40, 1};
+    file[0xD0] = static_cast<uint8_t>(pattern.size() + 64);
+    file.insert(file.end(), pattern.begin(), pattern.end());
+    file.resize(file.size() + 64);
+    return file;
+}
+
+static const size_t song_frames = 64 * 882;
+
+TEST(ModuleRenderer, RendersFromMemoryUntilTheSongEnds)
+{
+    const auto s3m = tiny_s3m();
+    auto renderer = ModuleRenderer::from_memory(s3m.data(), s3m.size(), ModuleFormat::s3m);
+    ASSERT_TRUE(renderer);
+    EXPECT_EQ(renderer->sample_rate(), 44100U);
+
+    std::vector<float> buffer(ModuleRenderer::channels * 1000);
+    size_t frames = 0;
+    bool heard = false;
+    while (!renderer->finished()) {
+        const size_t rendered = renderer->render(buffer.data(), 1000);
+        heard |= std::any_of(buffer.data(), buffer.data() + 2 * rendered,
+                             [](float v) { return v != 0; });
+        frames += rendered;
+    }
+    EXPECT_EQ(frames, song_frames);
+    EXPECT_TRUE(heard);
+    EXPECT_EQ(renderer->render(buffer.data(), 1000), 0UL);
+}
+
+TEST(ModuleRenderer, LoopsWhenAskedTo)
+{
+    const auto s3m = tiny_s3m();
+    auto renderer =
+        ModuleRenderer::from_memory(s3m.data(), s3m.size(), ModuleFormat::s3m, false);
+    ASSERT_TRUE(renderer);
+    std::vector<float> buffer(ModuleRenderer::channels * song_frames);
+    EXPECT_EQ(renderer->render(buffer.data(), song_frames), song_frames);
+    EXPECT_EQ(renderer->render(buffer.data(), song_frames), song_frames);
+    EXPECT_FALSE(renderer->finished());
+}
+
+TEST(ModuleRenderer, LoadsFromFiles)
+{
+    const auto s3m = tiny_s3m();
+    const auto path = testing::TempDir() + "module_renderer.s3m";
+    std::ofstream(path, std::ios::binary)
+        .write(reinterpret_cast<const char*>(s3m.data()), static_cast<std::streamsize>(s3m.size()));
+
+    auto renderer = ModuleRenderer::from_file(path);
+    ASSERT_TRUE(renderer);
+    std::vector<float> buffer(ModuleRenderer::channels * 2 * song_frames);
+    EXPECT_EQ(renderer->render(buffer.data(), 2 * song_frames), song_frames);
+    std::remove(path.c_str());
+}
+
+TEST(ModuleRenderer, RefusesWhatItCantPlay)
+{
+    EXPECT_FALSE(ModuleRenderer::from_file(testing::TempDir() + "no_such_module.s3m"));
+    EXPECT_FALSE(ModuleRenderer::from_file(testing::TempDir() + "no_such_module.mp3"));
+
+    const std::vector<uint8_t> zeros(0x100);
+    EXPECT_FALSE(ModuleRenderer::from_memory(zeros.data(), zeros.size(), ModuleFormat::s3m));
+
+    // At speed 0 no row would ever end
+    auto stuck = tiny_s3m();
+    stuck[0x31] = 0;
+    EXPECT_FALSE(ModuleRenderer::from_memory(stuck.data(), stuck.size(), ModuleFormat::s3m));
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <player/Module.h>
+#include <player/OfflineRenderer.h>
+#include <player/PerfCounters.h>
+#include <player/Player.h>
+#include <player/SongTimeline.h>
+
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+class OfflineRendererTest : public ::testing::Test {
+  protected:
+    void SetUp() override
+    {
+        mod = std::make_shared<Module>();
+        mod->initial_speed = 2;
+        mod->initial_tempo = 125;
+        mod->patterns.resize(1, Pattern(3));
+        mod->patternOrder = {0, 0, 255};
+        mod->samples.emplace_back(Sample{{0.5f, 1.0f, 0.5f, -1.0f}, 8363});
+        ASSERT_TRUE(parse_pattern(R"(C-5 01 .. .00
+                                     ... .. .. .00
+                                     D-5 01 .. .00)",
+                                  mod->patterns[0]));
+    }
+
+    std::shared_ptr<Module> mod;
+    // Two orders of three rows of two ticks
+    const size_t song_frames = 2 * 3 * 2 * 882;
+};
+
+TEST_F(OfflineRendererTest, StopsWhereTheSongEnds)
+{
+    Player player(mod);
+    OfflineRenderer renderer(player);
+    std::vector<float> buffer(2 * 10000);
+    EXPECT_EQ(renderer.render(&buffer[0], 1000), 1000UL);
+    EXPECT_FALSE(renderer.song_ended());
+    EXPECT_EQ(renderer.render(&buffer[0], 10000), song_frames - 1000);
+    EXPECT_TRUE(renderer.song_ended());
+    EXPECT_EQ(renderer.render(&buffer[0], 10000), 0UL);
+}
+
+TEST_F(OfflineRendererTest, RendersTheWholeSongInOneBlock)
+{
+    Player player(mod);
+    PerfCounters counters;
+    player.set_perf_counters(&counters);
+    OfflineRenderer renderer(player);
+    std::vector<float> buffer(2 * OfflineRenderer::block_frames);
+    EXPECT_EQ(renderer.render(&buffer[0], OfflineRenderer::block_frames), song_frames);
+    EXPECT_TRUE(renderer.song_ended());
+
+    // Stopping short of the tick that starts the song over, rather than running it
+    const auto snapshot = counters.snapshot();
+    EXPECT_EQ(snapshot.renders, 1UL);
+    EXPECT_EQ(snapshot.rendered_frames, song_frames);
+    EXPECT_EQ(snapshot.ticks, 2UL * 3 * 2);
+    EXPECT_EQ(player.times_looped, 0UL);
+}
+
+TEST_F(OfflineRendererTest, StopsWhereAJumpGoesBack)
+{
+    // The third order jumps back to the second, so the order list never comes round to the
+    // start again
+    mod->patterns.push_back(mod->patterns[0]);
+    mod->patterns[1].entry(2, 0).effect = {PatternEntry::Command::jump_to_order, 1};
+    mod->patternOrder = {0, 0, 1, 255};
+    const size_t jump_frames = 3 * 3 * 2 * 882;
+
+    Player player(mod);
+    std::ostringstream wav;
+    EXPECT_EQ(render_to_wav(player, wav), jump_frames);
+    EXPECT_EQ(wav.str().size(), 44 + 2 * sizeof(int16_t) * jump_frames);
+    EXPECT_EQ(SongTimeline(mod).frames(), jump_frames);
+}
+
+TEST_F(OfflineRendererTest, RendersWhatThePlayerDoes)
+{
+    Player direct(mod);
+    std::vector<float> expected(2 * song_frames);
+    direct.render_stereo_audio(&expected[0], static_cast<int>(song_frames));
+
+    Player player(mod);
+    OfflineRenderer renderer(player);
+    // In uneven pieces
+    std::vector<float> buffer(2 * (song_frames + 777));
+    size_t rendered = 0;
+    while (!renderer.song_ended()) {
+        rendered += renderer.render(&buffer[2 * rendered], 777);
+    }
+    ASSERT_EQ(rendered, song_frames);
+    buffer.resize(2 * song_frames);
+    EXPECT_EQ(buffer, expected);
+}
+
+TEST_F(OfflineRendererTest, CanKeepGoingPastTheEnd)
+{
+    Player player(mod);
+    OfflineRenderer renderer(player, false);
+    std::vector<float> buffer(2 * 2 * song_frames);
+    EXPECT_EQ(renderer.render(&buffer[0], 2 * song_frames), 2 * song_frames);
+    EXPECT_FALSE(renderer.song_ended());
+    EXPECT_EQ(player.times_looped, 1UL);
+}
@@ -172,6 +172,45 @@ TEST(ParsePatternsFromText, CanParseMultipleChannels)
     EXPECT_EQ(result, expected);
 }
 
+TEST(PatternStorage, KeepsEachRowsChannelsSideBySide)
+{
+    Pattern pattern(4);
+    const PatternEntry entry{PatternEntry::Note{0, 4}, 3};
+    pattern.channel(5).row(2) = entry;
+    EXPECT_EQ(pattern.entry(2, 5), entry);
+    EXPECT_EQ(pattern.row(2)[5], entry);
+    EXPECT_EQ(&pattern.entry(2, 5), pattern.row(0) + 2 * pattern.channel_count() + 5);
+    EXPECT_EQ(pattern.row(3), pattern.row(2) + pattern.channel_count());
+
+    const Pattern& view = pattern;
+    EXPECT_EQ(view.channel(5).row(2), entry);
+    EXPECT_EQ(view.channel(5).row_count(), 4UL);
+    EXPECT_EQ(view.channel(4).row(2), PatternEntry());
+}
+
+TEST(PatternStorage, NarrowsAndWidensKeepingEveryEntry)
+{
+    Pattern pattern(4, 16);
+    EXPECT_EQ(pattern.channel_count(), 16UL);
+    EXPECT_EQ(pattern.used_channel_count(), 0UL);
+    const PatternEntry entry{PatternEntry::Note{0, 4}, 3};
+    pattern.entry(3, 5) = entry;
+    pattern.entry(1, 2) = entry;
+    EXPECT_EQ(pattern.used_channel_count(), 6UL);
+
+    pattern.set_channel_count(6);
+    EXPECT_EQ(pattern.channel_count(), 6UL);
+    EXPECT_EQ(pattern.entry(3, 5), entry);
+    EXPECT_EQ(pattern.entry(1, 2), entry);
+    EXPECT_EQ(pattern.row(1) + 6, pattern.row(2));
+
+    pattern.set_channel_count(100);
+    EXPECT_EQ(pattern.channel_count(), Pattern::max_channels);
+    EXPECT_EQ(pattern.entry(3, 5), entry);
+    EXPECT_EQ(pattern.entry(3, 63), PatternEntry());
+    EXPECT_EQ(pattern.used_channel_count(), 6UL);
+}
+
 TEST(PatternEntryNotes, CanInitializeWithRawValue)
 {
     using NoteName = Pattern::Entry::Note::Name;
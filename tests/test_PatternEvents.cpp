@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+
+#include <player/Pattern.h>
+#include <player/PatternEvents.h>
+
+#include <vector>
+
+TEST(PatternEvents, KeepsOnlyTheNonEmptyEntriesOfEachRow)
+{
+    Pattern pattern(4);
+    ASSERT_TRUE(parse_pattern(R"(C-5 01 .. .00 ... .. .. .00 E-5 02 .. .00
+                                 ... .. .. .00 ... .. 32 .00 ... .. .. .00
+                                 ... .. .. .00 ... .. .. .00 ... .. .. .00
+                                 ... .. .. D04 ... .. .. .00 ^^^ .. .. .00)",
+                              pattern));
+    pattern.entry(3, 31) = {PatternEntry::Note{}, 3};
+
+    const PatternEvents events(pattern);
+    ASSERT_EQ(events.row_count(), 4UL);
+
+    auto channels_of = [&](size_t r) {
+        std::vector<size_t> channels;
+        for (const auto& cell : events.row(r)) {
+            EXPECT_EQ(cell.entry, pattern.entry(r, cell.channel));
+            channels.push_back(cell.channel);
+        }
+        return channels;
+    };
+    EXPECT_EQ(channels_of(0), (std::vector<size_t>{0, 2}));
+    EXPECT_EQ(channels_of(1), (std::vector<size_t>{1}));
+    EXPECT_TRUE(channels_of(2).empty());
+    EXPECT_EQ(channels_of(3), (std::vector<size_t>{0, 2, 31}));
+
+    EXPECT_EQ(events.row(0).channels, 0b101UL);
+    EXPECT_EQ(events.row(2).channels, 0UL);
+    EXPECT_EQ(events.row(3).channels, 0b101UL | 1UL << 31);
+}
+
+TEST(PatternEvents, FlagsRowsWithGlobalCommands)
+{
+    Pattern pattern(5);
+    ASSERT_TRUE(parse_pattern(R"(... .. .. A04 C-5 01 .. .00
+                                 ... .. .. .00 ... .. .. B02
+                                 ... .. .. .00 ... .. .. C10
+                                 ... .. .. T80 ... .. .. .00
+                                 C-5 01 40 H44 ... .. .. D0F)",
+                              pattern));
+
+    const PatternEvents events(pattern);
+    EXPECT_TRUE(events.row(0).has_global_commands);
+    EXPECT_TRUE(events.row(1).has_global_commands);
+    EXPECT_TRUE(events.row(2).has_global_commands);
+    EXPECT_TRUE(events.row(3).has_global_commands);
+    EXPECT_FALSE(events.row(4).has_global_commands);
+}
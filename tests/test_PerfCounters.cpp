@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <player/Module.h>
+#include <player/PerfCounters.h>
+#include <player/Player.h>
+
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+TEST(PerfCounters, BucketsDoubleInWidth)
+{
+    EXPECT_EQ(PerfCounters::histogram_bucket(0ns), 0UL);
+    EXPECT_EQ(PerfCounters::histogram_bucket(31us), 0UL);
+    EXPECT_EQ(PerfCounters::histogram_bucket(32us), 1UL);
+    EXPECT_EQ(PerfCounters::histogram_bucket(63us), 1UL);
+    EXPECT_EQ(PerfCounters::histogram_bucket(64us), 2UL);
+    EXPECT_EQ(PerfCounters::histogram_bucket(1ms), 5UL);
+    EXPECT_EQ(PerfCounters::histogram_bucket(10s), PerfCounters::histogram_buckets - 1);
+}
+
+TEST(PerfCounters, CountsCallbacksAgainstTheirDeadlines)
+{
+    PerfCounters counters;
+    counters.record_callback(100us, 5ms);
+    counters.record_callback(6ms, 5ms);
+    counters.record_callback(2ms, 5ms);
+    counters.record_underflow();
+
+    const auto snapshot = counters.snapshot();
+    EXPECT_EQ(snapshot.callbacks, 3UL);
+    EXPECT_EQ(snapshot.deadline_misses, 1UL);
+    EXPECT_EQ(snapshot.underflows, 1UL);
+    EXPECT_EQ(snapshot.overflows, 0UL);
+    EXPECT_EQ(snapshot.callback_ns, 8100000);
+    EXPECT_EQ(snapshot.max_callback_ns, 6000000);
+    EXPECT_EQ(snapshot.deadline_ns, 5000000);
+    EXPECT_EQ(snapshot.histogram[PerfCounters::histogram_bucket(100us)], 1UL);
+    EXPECT_EQ(snapshot.histogram[PerfCounters::histogram_bucket(2ms)], 1UL);
+    EXPECT_EQ(snapshot.histogram[PerfCounters::histogram_bucket(6ms)], 1UL);
+
+    std::ostringstream os;
+    os << snapshot;
+    EXPECT_NE(os.str().find("1 over deadline"), std::string::npos) << os.str();
+}
+
+TEST(PerfCounters, PlayerRecordsTicksAndRenders)
+{
+    auto mod = std::make_shared<Module>();
+    mod->initial_speed = 2;
+    mod->initial_tempo = 125;
+    mod->patterns.resize(1, Pattern(2));
+    mod->patternOrder = {0, 255};
+    mod->samples.emplace_back(Sample{{0.5f, 1.0f, 0.5f, -1.0f}, 8363});
+    ASSERT_TRUE(parse_pattern(R"(C-5 01 .. .00 D-5 01 .. .00
+                                 ... .. 32 .00 ... .. .. .00)",
+                              mod->patterns[0]));
+
+    PerfCounters counters;
+    Player player(mod);
+    player.set_perf_counters(&counters);
+    std::vector<float> buffer(2 * 882);
+    for (int i = 0; i < 4; ++i) {
+        player.render_stereo_audio(&buffer[0], 882);
+    }
+
+    const auto snapshot = counters.snapshot();
+    EXPECT_EQ(snapshot.renders, 4UL);
+    EXPECT_EQ(snapshot.rendered_frames, 4UL * 882);
+    EXPECT_EQ(snapshot.ticks, 4UL);
+    EXPECT_GT(snapshot.events, 0UL);
+    EXPECT_EQ(snapshot.max_active_voices, 2UL);
+    EXPECT_GE(snapshot.render_ns, snapshot.tick_ns);
+    EXPECT_EQ(snapshot.callbacks, 0UL);
+
+    player.set_perf_counters(nullptr);
+    player.render_stereo_audio(&buffer[0], 882);
+    EXPECT_EQ(counters.snapshot().renders, 4UL);
+}
+
+TEST(PerfCounters, SkippedTicksAreLeftOutOfRenderTime)
+{
+    auto mod = std::make_shared<Module>();
+    mod->initial_speed = 2;
+    mod->initial_tempo = 125;
+    mod->patterns.resize(1, Pattern(8));
+    mod->patternOrder = {0, 255};
+    mod->samples.emplace_back(Sample{{0.5f, 1.0f, 0.5f, -1.0f}, 8363});
+    ASSERT_TRUE(parse_pattern("C-5 01 .. .00", mod->patterns[0]));
+
+    PerfCounters counters;
+    Player player(mod);
+    player.set_perf_counters(&counters);
+    player.skip(4 * 882);
+    std::vector<float> buffer(2 * 882);
+    player.render_stereo_audio(&buffer[0], 882);
+
+    const auto snapshot = counters.snapshot();
+    EXPECT_EQ(snapshot.renders, 1UL);
+    EXPECT_EQ(snapshot.ticks, 1UL);
+    EXPECT_GE(snapshot.render_ns, snapshot.tick_ns);
+}
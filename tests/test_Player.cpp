@@ -879,6 +879,19 @@ TEST_F(PlayerBehavior, PlayerRendersAudio)
     EXPECT_EQ(mixer.channel(0).frequency(), 8363.0f);
 }
 
+TEST_F(PlayerBehavior, ChannelsStartAtModulePanning)
+{
+    mod->channel_panning = {0, 64, 16};
+
+    Player player(mod);
+
+    const auto& mixer = player.mixer();
+    EXPECT_EQ(mixer.channel(0).panning(), 0);
+    EXPECT_EQ(mixer.channel(1).panning(), 1.0f);
+    EXPECT_EQ(mixer.channel(2).panning(), 0.25f);
+    EXPECT_EQ(mixer.channel(3).panning(), 0.5f);
+}
+
 TEST_F(PlayerBehavior, PlayerSpeedHasSignificance)
 {
     ASSERT_TRUE(parse_pattern(R"(
@@ -907,4 +920,99 @@ TEST_F(PlayerBehavior, PlayerSpeedHasSignificance)
             {0, Channel::Event::SetVolume{1.0f}}};
         EXPECT_EQ(events, expected);
     }
-}
\ No newline at end of file
+}
+class PlayerCommands : public PlayerTest {
+  protected:
+    // Renders enough frames to take the player through its next tick
+    void render_tick(Player& player)
+    {
+        std::vector<float> buffer(player.mixer().samples_per_tick());
+        player.render_audio(&buffer[0], static_cast<int>(buffer.size()));
+    }
+};
+
+TEST_F(PlayerCommands, MuteAndSoloSetMixVolumesAtTheNextTick)
+{
+    ASSERT_TRUE(parse_pattern(R"(C-5 01 .. .00 C-5 01 32 .00 C-5 01 .. .00)", mod->patterns[0]));
+    Player player(mod);
+    const auto& mixer = player.mixer();
+
+    ASSERT_TRUE(player.send(PlayerCommand::Mute{0, true}));
+    render_tick(player);
+    EXPECT_EQ(mixer.channel(0).volume(), 0);
+    EXPECT_EQ(mixer.channel(1).volume(), 0.5f);
+    EXPECT_EQ(mixer.channel(2).volume(), 1.0f);
+
+    ASSERT_TRUE(player.send(PlayerCommand::Solo{1, true}));
+    render_tick(player);
+    EXPECT_EQ(mixer.channel(0).volume(), 0);
+    EXPECT_EQ(mixer.channel(1).volume(), 0.5f);
+    EXPECT_EQ(mixer.channel(2).volume(), 0);
+
+    ASSERT_TRUE(player.send(PlayerCommand::Solo{1, false}));
+    ASSERT_TRUE(player.send(PlayerCommand::Mute{0, false}));
+    ASSERT_TRUE(player.send(PlayerCommand::SetMasterVolume{0.5f}));
+    render_tick(player);
+    EXPECT_EQ(mixer.channel(0).volume(), 0.5f);
+    EXPECT_EQ(mixer.channel(1).volume(), 0.25f);
+    EXPECT_EQ(mixer.channel(2).volume(), 0.5f);
+}
+
+TEST_F(PlayerCommands, CanSeekAndSetTempo)
+{
+    ASSERT_TRUE(parse_pattern(R"(... .. 01 .00
+                                 ... .. 02 .00
+                                 ... .. 03 .00
+                                 ... .. 04 .00)",
+                              mod->patterns[0]));
+    Player player(mod);
+
+    ASSERT_TRUE(player.send(PlayerCommand::Seek{0, 2}));
+    render_tick(player);
+    EXPECT_EQ(player.mixer().channel(0).volume(), 3.0f / 64.0f);
+
+    // Out of range seeks are ignored
+    ASSERT_TRUE(player.send(PlayerCommand::Seek{0, 8}));
+    ASSERT_TRUE(player.send(PlayerCommand::Seek{7, 0}));
+    render_tick(player);
+    EXPECT_EQ(player.mixer().channel(0).volume(), 4.0f / 64.0f);
+
+    ASSERT_TRUE(player.send(PlayerCommand::SetTempo{250}));
+    render_tick(player);
+    EXPECT_EQ(player.tempo, 250);
+    EXPECT_EQ(player.mixer().samples_per_tick(), 441UL);
+}
+
+TEST_F(PlayerCommands, PauseSilencesOutputUntilResumed)
+{
+    ASSERT_TRUE(parse_pattern(R"(C-5 01 .. .00)", mod->patterns[0]));
+    Player player(mod);
+
+    // The pause lands at the tick starting this render, which still plays out
+    ASSERT_TRUE(player.send(PlayerCommand::Pause{true}));
+    std::vector<float> buffer(4, 0);
+    player.render_audio(&buffer[0], 4);
+    EXPECT_TRUE(player.is_paused());
+    EXPECT_NE(buffer[1], 0);
+
+    player.render_audio(&buffer[0], 4);
+    EXPECT_EQ(buffer, std::vector<float>(4, 0));
+
+    ASSERT_TRUE(player.send(PlayerCommand::Pause{false}));
+    player.render_audio(&buffer[0], 4);
+    EXPECT_FALSE(player.is_paused());
+    EXPECT_NE(buffer[0], 0);
+    EXPECT_GT(player.max_command_latency().count(), 0);
+}
+
+TEST_F(PlayerCommands, SendFailsWhenTheQueueIsFull)
+{
+    Player player(mod);
+    for (size_t i = 0; i < Player::command_capacity; ++i) {
+        ASSERT_TRUE(player.send(PlayerCommand::SetMasterVolume{1.0f}));
+    }
+    EXPECT_FALSE(player.send(PlayerCommand::SetMasterVolume{1.0f}));
+
+    render_tick(player);
+    EXPECT_TRUE(player.send(PlayerCommand::SetMasterVolume{1.0f}));
+}
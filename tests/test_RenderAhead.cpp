@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include <player/Module.h>
+#include <player/Player.h>
+#include <player/RenderAhead.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+static std::shared_ptr<Module> make_module()
+{
+    auto mod = std::make_shared<Module>();
+    mod->initial_speed = 2;
+    mod->initial_tempo = 125;
+    mod->patterns.resize(1, Pattern(4));
+    mod->patternOrder = {0, 255};
+    std::vector<float> data(100);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<float>(i % 11) / 11.0f - 0.5f;
+    }
+    mod->samples.emplace_back(Sample{data.begin(), data.end(), 8363,
+                                     {Sample::LoopParams::Type::forward_looping, 20}});
+    EXPECT_TRUE(parse_pattern(R"(C-5 01 .. .00 G-5 01 32 .00
+                                 ... .. .. D04 ... .. .. .00
+                                 D-5 01 .. .00 ... .. .. .00
+                                 ... .. .. .00 C-6 01 48 .00)",
+                              mod->patterns[0]));
+    return mod;
+}
+
+TEST(RenderAhead, PlaysWhatThePlayerRenders)
+{
+    const auto mod = make_module();
+    Player direct(mod);
+    Player ahead(mod);
+    RenderAhead render_ahead(ahead, 1000, 128);
+    EXPECT_EQ(render_ahead.fill_level(), 896UL);
+
+    for (size_t frames : {1UL, 300UL, 77UL, 896UL, 512UL, 5UL}) {
+        while (render_ahead.fill_level() < frames) {
+            std::this_thread::yield();
+        }
+        std::vector<float> expected(2 * frames);
+        direct.render_stereo_audio(&expected[0], static_cast<int>(frames));
+        std::vector<float> buffer(2 * frames);
+        render_ahead.read(&buffer[0], frames);
+        ASSERT_EQ(buffer, expected) << frames << " frames";
+    }
+    EXPECT_EQ(render_ahead.underruns(), 0UL);
+    EXPECT_LE(render_ahead.fill_level(), render_ahead.lookahead_frames());
+}
+
+TEST(RenderAhead, UnderrunsPadWithSilenceAndAreCounted)
+{
+    const auto mod = make_module();
+    Player player(mod);
+    RenderAhead render_ahead(player, 64, 64);
+
+    // Never more than the lookahead is ready
+    std::vector<float> buffer(2 * 1000, 1.0f);
+    render_ahead.read(&buffer[0], 1000);
+    EXPECT_EQ(render_ahead.underruns(), 1UL);
+    EXPECT_GE(render_ahead.underrun_frames(), 1000UL - 64);
+    const size_t ready = 1000 - render_ahead.underrun_frames();
+    EXPECT_NE(buffer[2 * ready - 1], 0);
+    for (size_t i = 2 * ready; i < buffer.size(); ++i) {
+        ASSERT_EQ(buffer[i], 0) << "sample " << i;
+    }
+}
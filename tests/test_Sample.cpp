@@ -77,4 +77,47 @@ TEST(Sample, NonLoopingSamplesLerpToZeroAtEnd)
 {
     Sample sample({1.0f}, 1, {Sample::LoopParams::Type::non_looping});
     EXPECT_EQ(sample[0.5f], 0.5f);
-}
\ No newline at end of file
+}
+TEST(Sample, GuardFramesRepeatTheLoopPastItsEnd)
+{
+    std::vector<float> sample_data{0.1f, 0.2f, 0.3f, 0.4f, 0.5f};
+    Sample sample(sample_data.begin(), sample_data.end(), 1,
+                  {Sample::LoopParams::Type::forward_looping, 1, 3});
+    const float* data = sample.data();
+
+    for (size_t i = 1; i <= Sample::guard_frames; ++i) {
+        EXPECT_EQ(*(data - i), 0) << "frame -" << i;
+    }
+    for (size_t i = 0; i < Sample::guard_frames; ++i) {
+        EXPECT_EQ(data[3 + i], i % 2 ? 0.3f : 0.2f) << "frame " << 3 + i;
+    }
+    // The frames after the loop end are still there
+    EXPECT_EQ(sample[3UL], 0.4f);
+    EXPECT_EQ(sample[4UL], 0.5f);
+}
+
+TEST(Sample, GuardFramesAreSilentAfterOneShots)
+{
+    Sample sample({0.5f, 1.0f}, 1, {Sample::LoopParams::Type::non_looping});
+    const float* data = sample.data();
+
+    for (size_t i = 0; i < Sample::guard_frames; ++i) {
+        EXPECT_EQ(data[2 + i], 0) << "frame " << 2 + i;
+    }
+
+    sample.add_pcm16();
+    EXPECT_EQ(sample.pcm16()[1], 32767);
+    EXPECT_EQ(sample.pcm16()[2], 0);
+}
+
+TEST(Sample, KeepsA16BitCopyOnlyForFixedPointMixing)
+{
+    Sample sample({0.5f, 1.0f}, 1);
+#ifdef IMPULSE_FIXED_POINT
+    EXPECT_TRUE(sample.has_pcm16());
+#else
+    EXPECT_FALSE(sample.has_pcm16());
+#endif
+    sample.add_pcm16();
+    EXPECT_TRUE(sample.has_pcm16());
+}
@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+
+#include <player/Module.h>
+#include <player/OfflineRenderer.h>
+#include <player/Player.h>
+#include <player/SeekIndex.h>
+#include <player/SongTimeline.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+class SeekIndexTest : public ::testing::Test {
+  protected:
+    void SetUp() override
+    {
+        mod = std::make_shared<Module>();
+        mod->initial_speed = 3;
+        mod->initial_tempo = 125;
+        mod->patterns.resize(2, Pattern(8));
+        mod->patternOrder = {0, 1, 0, 255};
+        std::vector<float> data(200);
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = std::sin(static_cast<float>(i) * 0.3f);
+        }
+        mod->samples.emplace_back(
+            Sample{data.begin(), data.end(), 8363,
+                   {Sample::LoopParams::Type::forward_looping, 50, data.size()}});
+        mod->samples.emplace_back(
+            Sample{data.begin(), data.end(), 8363, {Sample::LoopParams::Type::non_looping}});
+        // Slides, vibrato and portamento carry over from row to row, and the tempo changes
+        // part way through
+        ASSERT_TRUE(parse_pattern(R"(C-5 01 48 H44 E-5 02 64 .00
+                                     ... .. .. H00 ... .. .. D04
+                                     ... .. .. F08 G-5 02 .. .00
+                                     ... .. .. F00 ... .. .. .00
+                                     D-5 01 .. G10 C-5 02 32 .00
+                                     ... .. .. G00 ... .. .. D40
+                                     ... .. .. D02 ... .. .. .00
+                                     ... .. .. .00 ... .. .. .00)",
+                                  mod->patterns[0]));
+        ASSERT_TRUE(parse_pattern(R"(F-5 02 64 .00 A-5 01 40 J37
+                                     ... .. .. E04 ... .. .. J00
+                                     ... .. .. T60 ... .. .. .00
+                                     ... .. .. .00 C-6 02 .. .00
+                                     ... .. .. .00 ... .. .. H82
+                                     C-5 01 .. .00 ... .. .. .00
+                                     ... .. .. .00 ... .. .. .00
+                                     ... .. .. .00 ... .. .. .00)",
+                                  mod->patterns[1]));
+
+        Player player(mod);
+        OfflineRenderer renderer(player);
+        reference.resize(2 * 200000);
+        song_frames = renderer.render(&reference[0], 200000);
+        reference.resize(2 * song_frames);
+    }
+
+    // Renders from wherever `player` is and compares it with playing from the start
+    void expect_plays_from(Player& player, size_t frame)
+    {
+        const size_t frames = std::min(size_t{3000}, song_frames - frame);
+        std::vector<float> buffer(2 * frames);
+        player.render_stereo_audio(&buffer[0], static_cast<int>(frames));
+        for (size_t i = 0; i < buffer.size(); ++i) {
+            ASSERT_NEAR(buffer[i], reference[2 * frame + i], 1e-6f)
+                << "frame " << frame + i / 2;
+        }
+    }
+
+    std::shared_ptr<Module> mod;
+    std::vector<float> reference;
+    size_t song_frames = 0;
+};
+
+TEST_F(SeekIndexTest, ScansTheSongOnce)
+{
+    SeekIndex index(mod, 4);
+    EXPECT_TRUE(index.song_ended());
+    EXPECT_EQ(index.frames(), song_frames);
+    ASSERT_EQ(index.rows().size(), 3 * 8UL);
+    EXPECT_EQ(index.snapshots().size(), 6UL);
+    EXPECT_EQ(index.rows()[8].order, 1U);
+    EXPECT_EQ(index.rows()[8].row, 0U);
+    EXPECT_EQ(index.rows()[8].frame, 8 * 3 * 882UL);
+}
+
+TEST_F(SeekIndexTest, StopsWhereASongJumpsBack)
+{
+    // Order 1 jumps back to itself, so the order list never comes back round to the start
+    mod->patterns[1].entry(7, 0).effect = {PatternEntry::Command::jump_to_order, 1};
+    SeekIndex index(mod, 4);
+    EXPECT_TRUE(index.song_ended());
+    EXPECT_EQ(index.frames(), SongTimeline(mod).frames());
+    EXPECT_EQ(index.rows().size(), 2 * 8UL);
+    EXPECT_EQ(index.snapshots().size(), 4UL);
+}
+
+TEST_F(SeekIndexTest, FindsWhereRowsFirstStart)
+{
+    SeekIndex index(mod, 4);
+    EXPECT_EQ(index.frame_of(0, 0), 0UL);
+    EXPECT_EQ(index.frame_of(0, 5), 5 * 3 * 882UL);
+    EXPECT_EQ(index.frame_of(1, 0), 8 * 3 * 882UL);
+    EXPECT_EQ(index.frame_of(3, 0), std::nullopt);
+    EXPECT_EQ(index.frame_of(0, 8), std::nullopt);
+}
+
+TEST_F(SeekIndexTest, SeeksAnywhereAsThoughPlayedFromTheStart)
+{
+    SeekIndex index(mod, 4);
+    for (const size_t frame : {0UL, 1UL, 2646UL, 10000UL, 21169UL, 33333UL, 50000UL,
+                               song_frames - 10}) {
+        Player player(mod);
+        ASSERT_TRUE(index.seek(player, frame));
+        expect_plays_from(player, frame);
+    }
+    Player player(mod);
+    EXPECT_FALSE(index.seek(player, song_frames + 1));
+}
+
+TEST_F(SeekIndexTest, CarriesEffectsAndTempoAcrossTheSeek)
+{
+    SeekIndex index(mod, 4);
+    Player player(mod);
+    ASSERT_TRUE(index.seek(player, *index.frame_of(1, 4)));
+    EXPECT_EQ(player.tempo, 0x60);
+    EXPECT_EQ(player.current_order, 1UL);
+    EXPECT_EQ(player.current_row, 4UL);
+}
+
+TEST_F(SeekIndexTest, CommandsSeekThroughTheIndex)
+{
+    auto index = std::make_shared<const SeekIndex>(mod, 4);
+    Player player(mod);
+    player.set_seek_index(index);
+    // Commands are picked up at the next tick, and indexed seeks carried out at the start of
+    // the render after
+    auto render_to_next_tick = [&] {
+        const size_t frames = player.mixer().samples_until_next_tick() + 1;
+        std::vector<float> buffer(2 * frames);
+        player.render_stereo_audio(&buffer[0], static_cast<int>(frames));
+    };
+
+    player.send(PlayerCommand::Seek{1, 3});
+    render_to_next_tick();
+    expect_plays_from(player, *index->frame_of(1, 3));
+
+    player.send(PlayerCommand::SeekTime{1.0});
+    render_to_next_tick();
+    expect_plays_from(player, 44100);
+}
+
+TEST_F(SeekIndexTest, KeepsMuteAcrossTheSeek)
+{
+    SeekIndex index(mod, 4);
+    Player player(mod);
+    player.send(PlayerCommand::Mute{0, true});
+    player.send(PlayerCommand::Mute{1, true});
+    std::vector<float> buffer(2 * 1000);
+    player.render_stereo_audio(&buffer[0], 1000);
+
+    ASSERT_TRUE(index.seek(player, 20000));
+    EXPECT_TRUE(player.channels[0].muted);
+    player.render_stereo_audio(&buffer[0], 1000);
+    for (const auto v : buffer) {
+        ASSERT_EQ(v, 0.0f);
+    }
+}
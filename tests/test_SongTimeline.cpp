@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+
+#include <player/Module.h>
+#include <player/OfflineRenderer.h>
+#include <player/Player.h>
+#include <player/SongTimeline.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class SongTimelineTest : public ::testing::Test {
+  protected:
+    void SetUp() override
+    {
+        mod = std::make_shared<Module>();
+        mod->initial_speed = 3;
+        mod->initial_tempo = 125;
+        mod->patterns.resize(3, Pattern(8));
+    }
+
+    std::shared_ptr<Module> mod;
+    // At speed 3 and tempo 125
+    const size_t row_frames = 3 * 882;
+};
+
+TEST_F(SongTimelineTest, EndsWhereTheSongComesBackToTheStart)
+{
+    mod->patternOrder = {0, 1, 0, 255};
+    ASSERT_TRUE(parse_pattern(R"(... .. .. .00
+                                 ... .. .. A02
+                                 ... .. .. .00
+                                 ... .. .. T60
+                                 ... .. .. .00
+                                 ... .. .. A05
+                                 ... .. .. T7D
+                                 ... .. .. A03)",
+                              mod->patterns[1]));
+
+    SongTimeline timeline(mod);
+    ASSERT_EQ(timeline.rows().size(), 3 * 8UL);
+    EXPECT_TRUE(timeline.loops_to_start());
+    ASSERT_TRUE(timeline.loop());
+    EXPECT_EQ(timeline.loop()->frame, 0UL);
+    EXPECT_EQ(timeline.rows()[8].frame, 8 * row_frames);
+    EXPECT_EQ(timeline.rows()[8].order, 1U);
+    EXPECT_EQ(timeline.rows()[16].order, 2U);
+    EXPECT_EQ(timeline.rows()[16].row, 0U);
+    EXPECT_EQ(timeline.frame_of(2, 0), timeline.rows()[16].frame);
+    EXPECT_EQ(timeline.sample_rate(), 44100UL);
+    EXPECT_DOUBLE_EQ(timeline.seconds(), static_cast<double>(timeline.frames()) / 44100);
+
+    // Exactly as long as rendering it, speed and tempo changes and all
+    Player player(mod);
+    OfflineRenderer renderer(player);
+    std::vector<float> buffer(2 * OfflineRenderer::block_frames);
+    size_t rendered = 0;
+    while (!renderer.song_ended()) {
+        rendered += renderer.render(&buffer[0], OfflineRenderer::block_frames);
+    }
+    EXPECT_EQ(timeline.frames(), rendered);
+}
+
+TEST_F(SongTimelineTest, LoopsBackWhereAJumpGoes)
+{
+    mod->patternOrder = {0, 1, 2, 255};
+    mod->patterns[2].channel(0).row(3).effect = {PatternEntry::Command::jump_to_order, 1};
+
+    SongTimeline timeline(mod);
+    ASSERT_EQ(timeline.rows().size(), 8 + 8 + 4UL);
+    EXPECT_FALSE(timeline.loops_to_start());
+    EXPECT_EQ(timeline.loop_index(), 8UL);
+    ASSERT_TRUE(timeline.loop());
+    EXPECT_EQ(timeline.loop()->order, 1U);
+    EXPECT_EQ(timeline.loop()->row, 0U);
+    EXPECT_EQ(timeline.loop()->frame, 8 * row_frames);
+    EXPECT_EQ(timeline.frames(), 20 * row_frames);
+    EXPECT_EQ(timeline.frame_of(2, 3), 19 * row_frames);
+    EXPECT_FALSE(timeline.frame_of(2, 4));
+}
+
+TEST_F(SongTimelineTest, FollowsBreaksAndSkipsMarkers)
+{
+    mod->patternOrder = {0, 254, 2, 255};
+    mod->patterns[0].channel(5).row(1).effect = {PatternEntry::Command::break_to_row, 4};
+
+    SongTimeline timeline(mod);
+    ASSERT_EQ(timeline.rows().size(), 2 + 4UL);
+    EXPECT_EQ(timeline.rows()[2].order, 2U);
+    EXPECT_EQ(timeline.rows()[2].row, 4U);
+    EXPECT_EQ(timeline.frame_of(2, 4), 2 * row_frames);
+    EXPECT_FALSE(timeline.frame_of(0, 2));
+    EXPECT_FALSE(timeline.frame_of(1, 0));
+    EXPECT_FALSE(timeline.frame_of(9, 0));
+    EXPECT_TRUE(timeline.loops_to_start());
+    EXPECT_EQ(timeline.frames(), 6 * row_frames);
+}
+
+TEST_F(SongTimelineTest, EndsAtABreakPastTheEndOfThePattern)
+{
+    mod->patternOrder = {0, 1, 255};
+    mod->patterns[0].channel(0).row(2).effect = {PatternEntry::Command::break_to_row, 32};
+
+    SongTimeline timeline(mod);
+    EXPECT_EQ(timeline.rows().size(), 3UL);
+    EXPECT_EQ(timeline.frames(), 3 * row_frames);
+    EXPECT_FALSE(timeline.loop());
+    EXPECT_FALSE(timeline.loops_to_start());
+}
+
+TEST_F(SongTimelineTest, PlaysNothingWithoutAnOrderToStartFrom)
+{
+    for (const auto& order : std::vector<std::vector<uint8_t>>{{}, {255}, {254, 255}}) {
+        mod->patternOrder = order;
+        SongTimeline timeline(mod);
+        EXPECT_TRUE(timeline.rows().empty());
+        EXPECT_EQ(timeline.frames(), 0UL);
+        EXPECT_FALSE(timeline.loop());
+        EXPECT_FALSE(timeline.loop_index());
+        EXPECT_FALSE(timeline.loops_to_start());
+    }
+}
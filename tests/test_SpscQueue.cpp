@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+
+#include <player/SpscQueue.h>
+
+#include <thread>
+
+TEST(SpscQueue, PopsInPushOrder)
+{
+    SpscQueue<int, 4> queue;
+    int value = 0;
+    EXPECT_FALSE(queue.pop(value));
+
+    EXPECT_TRUE(queue.push(1));
+    EXPECT_TRUE(queue.push(2));
+    ASSERT_TRUE(queue.pop(value));
+    EXPECT_EQ(value, 1);
+    EXPECT_TRUE(queue.push(3));
+    ASSERT_TRUE(queue.pop(value));
+    EXPECT_EQ(value, 2);
+    ASSERT_TRUE(queue.pop(value));
+    EXPECT_EQ(value, 3);
+    EXPECT_FALSE(queue.pop(value));
+}
+
+TEST(SpscQueue, RefusesPushesWhenFull)
+{
+    SpscQueue<int, 4> queue;
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.push(i));
+    }
+    EXPECT_FALSE(queue.push(4));
+
+    int value = 0;
+    ASSERT_TRUE(queue.pop(value));
+    EXPECT_EQ(value, 0);
+    EXPECT_TRUE(queue.push(4));
+}
+
+TEST(SpscQueue, HandsValuesBetweenThreadsInOrder)
+{
+    SpscQueue<size_t, 8> queue;
+    const size_t count = 100000;
+
+    std::thread producer([&] {
+        for (size_t i = 0; i < count; ++i) {
+            while (!queue.push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    size_t expected = 0;
+    while (expected < count) {
+        size_t value = 0;
+        if (queue.pop(value)) {
+            ASSERT_EQ(value, expected);
+            ++expected;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+}
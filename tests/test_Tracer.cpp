@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <player/Mixer.h>
+#include <player/Tracer.h>
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static size_t count(const std::string& text, const std::string& what)
+{
+    size_t n = 0;
+    for (auto at = text.find(what); at != std::string::npos; at = text.find(what, at + 1)) {
+        ++n;
+    }
+    return n;
+}
+
+TEST(Tracer, RecordsNothingUntilInstalled)
+{
+    std::ostringstream os;
+    {
+        Tracer tracer(os);
+        { TraceSpan span("before"); }
+        tracer.install();
+        EXPECT_EQ(Tracer::installed(), &tracer);
+        { TraceSpan span("during", "order", 3, "row", 12); }
+        tracer.uninstall();
+        { TraceSpan span("after"); }
+    }
+    EXPECT_EQ(Tracer::installed(), nullptr);
+
+    const auto trace = os.str();
+    EXPECT_EQ(trace.front(), '[');
+    EXPECT_EQ(trace.substr(trace.size() - 2), "]\n");
+    EXPECT_EQ(count(trace, R"("ph":"X")"), 1UL) << trace;
+    EXPECT_NE(trace.find(R"("name":"during")"), std::string::npos) << trace;
+    EXPECT_NE(trace.find(R"("args":{"order":3,"row":12})"), std::string::npos) << trace;
+}
+
+TEST(Tracer, GivesEachThreadItsOwnTrack)
+{
+    std::ostringstream os;
+    {
+        Tracer tracer(os);
+        tracer.install();
+        auto record = [] {
+            for (int i = 0; i < 100; ++i) {
+                TraceSpan span("work", "i", i);
+            }
+        };
+        std::thread first(record);
+        std::thread second(record);
+        first.join();
+        second.join();
+    }
+    const auto trace = os.str();
+    EXPECT_EQ(count(trace, R"("name":"work")"), 200UL);
+    EXPECT_EQ(count(trace, R"("tid":1,)"), 100UL);
+    EXPECT_EQ(count(trace, R"("tid":2,)"), 100UL);
+}
+
+TEST(Tracer, DropsSpansThatDontFit)
+{
+    std::ostringstream os;
+    {
+        Tracer tracer(os, 1, 8, std::chrono::hours(1));
+        tracer.install();
+        for (int i = 0; i < 10; ++i) {
+            TraceSpan span("work");
+        }
+        std::thread([] { TraceSpan span("no ring left"); }).join();
+        EXPECT_EQ(tracer.dropped(), 3UL);
+        tracer.flush();
+        { TraceSpan span("room again"); }
+        EXPECT_EQ(tracer.dropped(), 3UL);
+    }
+    EXPECT_EQ(count(os.str(), R"("ph":"X")"), 9UL);
+}
+
+TEST(Tracer, SpansMixerRendersAndVoices)
+{
+    Sample sample({1.0f, 0.5f, 0.25f, 0}, 1, {Sample::LoopParams::Type::forward_looping, 1});
+    Mixer mixer(44100, 4);
+    mixer.set_samples_per_tick(1000);
+    mixer.channel(1).play(&sample);
+    mixer.channel(3).play(&sample);
+
+    std::ostringstream os;
+    {
+        Tracer tracer(os);
+        tracer.install();
+        std::vector<float> buffer(2 * 256);
+        mixer.render_stereo(&buffer[0], 256);
+    }
+    const auto trace = os.str();
+    EXPECT_EQ(count(trace, R"("name":"Mixer::render")"), 1UL) << trace;
+    EXPECT_NE(trace.find(R"("args":{"frames":256})"), std::string::npos) << trace;
+    EXPECT_EQ(count(trace, R"("name":"voice")"), 2UL) << trace;
+    EXPECT_NE(trace.find(R"("args":{"channel":3})"), std::string::npos) << trace;
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include <player/Sample.h>
+#include <player/VoiceKernels.h>
+
+#include <cmath>
+#include <vector>
+
+static std::vector<float> make_sine(size_t length, float cycles)
+{
+    std::vector<float> data(length);
+    for (size_t i = 0; i < length; ++i) {
+        auto phase = static_cast<float>(i) / static_cast<float>(length);
+        data[i] = std::sin(6.2831853f * cycles * phase);
+    }
+    return data;
+}
+
+TEST(VoiceKernels, ScalarKernelMatchesSampleInterpolation)
+{
+    std::vector<float> data{0, 0.25f, 1.0f, -0.5f, 0.75f, 0};
+    Sample sample(data.begin(), data.end(), 1);
+
+    std::vector<float> expected;
+    for (float position = 0; expected.size() < 8; position += 0.5f) {
+        expected.push_back(sample[position] * 0.5f);
+    }
+    std::vector<float> buffer(expected.size());
+    auto end = voice_kernel<MonoGain>(VoiceKernelIsa::scalar)(&buffer[0], buffer.size(),
+                                                              sample.data(), 0, Phase::one / 2,
+                                                              {0.5f});
+
+    EXPECT_EQ(buffer, expected);
+    EXPECT_EQ(end, Phase::frames(4));
+}
+
+TEST(VoiceKernels, VectorKernelsMatchScalarWithinTolerance)
+{
+    const auto data = make_sine(4096, 37);
+    const size_t frames = 1024;
+
+    for (auto isa : {VoiceKernelIsa::sse2, VoiceKernelIsa::avx2}) {
+        if (!is_supported(isa)) {
+            continue;
+        }
+        for (float rate : {0.19f, 1.0f, 1.37f, 2.5f}) {
+            std::vector<float> expected(frames);
+            std::vector<float> buffer(frames);
+            const auto start = Phase::position(3.3f);
+            const auto step = Phase::position(rate);
+            auto expected_end = voice_kernel<MonoGain>(VoiceKernelIsa::scalar)(
+                &expected[0], frames, data.data(), start, step, {0.8f});
+            auto end =
+                voice_kernel<MonoGain>(isa)(&buffer[0], frames, data.data(), start, step, {0.8f});
+
+            EXPECT_EQ(end, expected_end);
+            for (size_t i = 0; i < frames; ++i) {
+                ASSERT_NEAR(buffer[i], expected[i], voice_kernel_tolerance)
+                    << "isa " << static_cast<int>(isa) << " rate " << rate << " frame " << i;
+            }
+        }
+    }
+}
+
+TEST(VoiceKernels, StereoKernelsInterleaveMonoOutput)
+{
+    const auto data = make_sine(4096, 37);
+    const size_t frames = 1021;
+    const StereoGain gain{0.8f, 0.3f};
+
+    for (auto isa : {VoiceKernelIsa::scalar, VoiceKernelIsa::sse2, VoiceKernelIsa::avx2}) {
+        if (!is_supported(isa)) {
+            continue;
+        }
+        std::vector<float> mono(frames);
+        std::vector<float> stereo(frames * 2, 0.25f);
+        const auto start = Phase::position(3.3f);
+        const auto step = Phase::position(1.37f);
+        auto mono_end =
+            voice_kernel<MonoGain>(isa)(&mono[0], frames, data.data(), start, step, {1.0f});
+        auto end =
+            voice_kernel<StereoGain>(isa)(&stereo[0], frames, data.data(), start, step, gain);
+
+        EXPECT_EQ(end, mono_end);
+        for (size_t i = 0; i < frames; ++i) {
+            ASSERT_FLOAT_EQ(stereo[i * 2], 0.25f + mono[i] * gain.left)
+                << "isa " << static_cast<int>(isa) << " frame " << i;
+            ASSERT_FLOAT_EQ(stereo[i * 2 + 1], 0.25f + mono[i] * gain.right)
+                << "isa " << static_cast<int>(isa) << " frame " << i;
+        }
+    }
+}
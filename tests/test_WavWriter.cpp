@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+
+#include <player/WavWriter.h>
+
+#include <sstream>
+#include <string>
+
+static uint32_t u32_at(const std::string& bytes, size_t offset)
+{
+    uint32_t value = 0;
+    for (size_t i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(static_cast<uint8_t>(bytes[offset + i])) << (8 * i);
+    }
+    return value;
+}
+
+static int16_t s16_at(const std::string& bytes, size_t offset)
+{
+    return static_cast<int16_t>(static_cast<uint8_t>(bytes[offset]) |
+                                static_cast<uint8_t>(bytes[offset + 1]) << 8);
+}
+
+TEST(WavWriter, WritesA16BitPcmHeader)
+{
+    std::ostringstream os;
+    WavWriter wav(os, 44100, 2);
+    wav.finish();
+
+    const auto bytes = os.str();
+    ASSERT_EQ(bytes.size(), 44UL);
+    EXPECT_EQ(bytes.substr(0, 4), "RIFF");
+    EXPECT_EQ(bytes.substr(8, 8), "WAVEfmt ");
+    EXPECT_EQ(u32_at(bytes, 20), 0x20001UL); // PCM, two channels
+    EXPECT_EQ(u32_at(bytes, 24), 44100UL);
+    EXPECT_EQ(u32_at(bytes, 28), 44100UL * 4);
+    EXPECT_EQ(u32_at(bytes, 32), 0x100004UL); // Four byte frames of 16 bit samples
+    EXPECT_EQ(bytes.substr(36, 4), "data");
+}
+
+TEST(WavWriter, FinishingPatchesTheSizes)
+{
+    std::ostringstream os;
+    {
+        WavWriter wav(os, 8000, 2);
+        const float frames[] = {0, 1.0f, -1.0f, 0.5f, 2.0f, -2.0f};
+        wav.write(frames, 2);
+        wav.write(frames + 4, 1);
+        EXPECT_EQ(wav.frames_written(), 3UL);
+    }
+
+    const auto bytes = os.str();
+    ASSERT_EQ(bytes.size(), 44UL + 12);
+    EXPECT_EQ(u32_at(bytes, 4), 36UL + 12);
+    EXPECT_EQ(u32_at(bytes, 40), 12UL);
+    const int16_t expected[] = {0, 32767, -32767, 16384, 32767, -32767};
+    for (size_t i = 0; i < 6; ++i) {
+        EXPECT_EQ(s16_at(bytes, 44 + 2 * i), expected[i]) << "sample " << i;
+    }
+}